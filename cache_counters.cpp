@@ -0,0 +1,57 @@
+#include "cache_counters.h"
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// Abre un contador del hilo actual en cualquier CPU, parado y sin contar el
+// núcleo del sistema (no requiere privilegios con perf_event_paranoid <= 2)
+static int open_counter(uint32_t type, uint64_t config) {
+    struct perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+}
+
+static uint64_t read_counter(int fd) {
+    uint64_t value = 0;
+    if (fd < 0 || read(fd, &value, sizeof(value)) != sizeof(value)) {
+        return 0;
+    }
+    return value;
+}
+
+CacheCounters::CacheCounters()
+    : l1d_fd(open_counter(PERF_TYPE_HW_CACHE,
+                          PERF_COUNT_HW_CACHE_L1D |
+                          (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                          (PERF_COUNT_HW_CACHE_RESULT_MISS << 16))),
+      llc_fd(open_counter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES)) {}
+
+CacheCounters::~CacheCounters() {
+    if (l1d_fd >= 0) close(l1d_fd);
+    if (llc_fd >= 0) close(llc_fd);
+}
+
+void CacheCounters::start() {
+    int fds[2] = {l1d_fd, llc_fd};
+    for (int fd : fds) {
+        if (fd < 0) continue;
+        ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+}
+
+CacheCounters::Reading CacheCounters::stop() {
+    int fds[2] = {l1d_fd, llc_fd};
+    for (int fd : fds) {
+        if (fd >= 0) ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+    }
+    return Reading{read_counter(l1d_fd), read_counter(llc_fd)};
+}
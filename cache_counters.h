@@ -0,0 +1,34 @@
+#ifndef CACHE_COUNTERS_H
+#define CACHE_COUNTERS_H
+
+#include <cstdint>
+
+// Contadores hardware de fallos de caché del hilo actual (perf_event_open
+// de Linux). Muchas máquinas virtuales y contenedores no los exponen: en ese
+// caso available() es false y las lecturas valen 0.
+class CacheCounters {
+public:
+    struct Reading {
+        uint64_t l1d_misses;    // Fallos de lectura en la caché de datos L1
+        uint64_t llc_misses;    // Fallos en la caché de último nivel
+    };
+
+    CacheCounters();
+    ~CacheCounters();
+
+    bool available() const { return l1d_fd >= 0 || llc_fd >= 0; }
+    bool has_l1d() const { return l1d_fd >= 0; }
+    bool has_llc() const { return llc_fd >= 0; }
+
+    void start();
+    Reading stop();
+
+private:
+    int l1d_fd;
+    int llc_fd;
+
+    CacheCounters(const CacheCounters&) = delete;
+    CacheCounters& operator=(const CacheCounters&) = delete;
+};
+
+#endif
@@ -0,0 +1,115 @@
+#ifndef IMAGE_BUFFER_H
+#define IMAGE_BUFFER_H
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+// Vista no propietaria de una imagen intercalada o de un plano
+struct ImageView {
+    unsigned char* data;
+    int width;
+    int height;
+    int channels;          // Bytes por píxel dentro de la vista
+    size_t stride;
+
+    unsigned char* row(int y) const { return data + y * stride; }
+};
+
+// Buffer de imagen contiguo: una sola asignación con un paso de fila (stride)
+// explícito, rellenado a múltiplos de línea de caché. La fila y empieza en
+// data + y * stride, sin tabla de punteros intermedia. Los píxeles se guardan
+// con su número de canales nativo, intercalados o en planos (un plano por
+// canal, uno tras otro dentro del mismo bloque).
+//
+// Opcionalmente cada plano (o la imagen intercalada) lleva un margen de
+// 'apron' píxeles por cada lado, reservado en la misma asignación: data
+// sigue apuntando al píxel (0, 0) y las filas y columnas del margen están
+// en índices negativos y a partir de width / height. Los núcleos de
+// remuestreo lo rellenan según el modo de borde y muestrean sobre padded()
+// sin comprobar límites cerca de los bordes.
+struct ImageBuffer {
+    static const size_t ROW_ALIGNMENT = 64;
+
+    unsigned char* data;   // Primer byte de la fila 0 (alineado a ROW_ALIGNMENT)
+    int width;
+    int height;
+    int channels;          // Canales (1 gris, 2 gris+alfa, 3 RGB, 4 RGBA)
+    bool planar;           // true: un plano de 1 byte/píxel por canal
+    size_t stride;         // Bytes entre filas consecutivas (de un plano)
+    int apron;             // Píxeles de margen a cada lado (0 sin margen)
+    void* block;           // Bloque tal como lo devolvió el asignador
+    std::shared_ptr<void> arena;        // Estado propio del motor (p. ej. su Buddy System)
+    void (*release)(ImageBuffer&);      // Devuelve block al motor que lo asignó (pixel_allocator.h)
+
+    ImageBuffer() : data(nullptr), width(0), height(0), channels(0), planar(false), stride(0), apron(0),
+                    block(nullptr), release(nullptr) {}
+
+    ImageBuffer(ImageBuffer&& other) noexcept : ImageBuffer() {
+        swap(other);
+    }
+
+    ImageBuffer& operator=(ImageBuffer&& other) noexcept {
+        swap(other);
+        return *this;
+    }
+
+    void swap(ImageBuffer& other) noexcept {
+        std::swap(data, other.data);
+        std::swap(width, other.width);
+        std::swap(height, other.height);
+        std::swap(channels, other.channels);
+        std::swap(planar, other.planar);
+        std::swap(stride, other.stride);
+        std::swap(apron, other.apron);
+        std::swap(block, other.block);
+        std::swap(arena, other.arena);
+        std::swap(release, other.release);
+    }
+
+    unsigned char* row(int y) { return data + y * stride; }
+    const unsigned char* row(int y) const { return data + y * stride; }
+
+    int pixel_bytes() const { return planar ? 1 : channels; }
+    size_t plane_size() const { return static_cast<size_t>(height + 2 * apron) * stride; }
+    
+    // Bytes entre el inicio de cada fila reservada y su píxel 0: el margen
+    // izquierdo redondeado para que las filas sigan alineadas
+    size_t margin_bytes() const { return aligned_stride(static_cast<size_t>(apron) * pixel_bytes()); }
+    
+    // Desplazamiento de data respecto al inicio del bloque de píxeles
+    size_t data_offset() const { return apron * stride + margin_bytes(); }
+    size_t size_bytes() const { return plane_size() * (planar ? channels : 1); }
+
+    ImageView view() const {
+        return ImageView{data, width, height, pixel_bytes(), stride};
+    }
+
+    ImageView plane(int c) const {
+        return ImageView{data + c * plane_size(), width, height, 1, stride};
+    }
+    // Alias sin propiedad (no se libera) del buffer con el margen incluido
+    // como parte de la imagen: mide width + 2 * apron por height + 2 * apron
+    // y su píxel (apron, apron) es el (0, 0) de este buffer
+    ImageBuffer padded() const {
+        ImageBuffer alias;
+        alias.data = data - apron * stride - apron * pixel_bytes();
+        alias.width = width + 2 * apron;
+        alias.height = height + 2 * apron;
+        alias.channels = channels;
+        alias.planar = planar;
+        alias.stride = stride;
+        return alias;
+    }
+    
+    explicit operator bool() const { return data != nullptr; }
+
+    static size_t aligned_stride(size_t row_bytes) {
+        return (row_bytes + ROW_ALIGNMENT - 1) & ~(ROW_ALIGNMENT - 1);
+    }
+
+    ImageBuffer(const ImageBuffer&) = delete;
+    ImageBuffer& operator=(const ImageBuffer&) = delete;
+};
+
+#endif
@@ -4,72 +4,219 @@
 #include <chrono>
 #include <stdexcept>
 #include <cstring>
+#include <cstdint>
+#include <algorithm>
+#include <climits>
 #include "stb_image.h"
 #include "stb_image_write.h"
+#include "simd_bilinear.h"
+#include "resampler.h"
+#include "cache_counters.h"
+#include "stream_store.h"
 
 //#define STB_IMAGE_IMPLEMENTATION
 //#define STB_IMAGE_WRITE_IMPLEMENTATION
 
-ImageProcessor::ImageProcessor() : width(0), height(0), channels(0), pixels(nullptr), using_buddy(false) {}
+ImageProcessor::ImageProcessor()
+    : width(0), height(0), channels(0),
+      allocator(PixelAllocator::of<PooledPixels>()), layout(Layout::Interleaved),
+      border_mode(BorderMode::Constant), border_apron(0),
+      tiled_rotation(false), output_tile(DEFAULT_OUTPUT_TILE), tile_prefetch(false),
+      fixed_point(false), rotation_engine(RotationEngine::Resample),
+      interpolation(Interpolation::Bilinear) {}
 
 ImageProcessor::~ImageProcessor() {
-    if (pixels) {
-        free_pixels(pixels, height, using_buddy);
-    }
+    free_pixels(pixels);
 }
 
-ImageProcessor::Pixel** ImageProcessor::allocate_pixels(int w, int h, bool use_buddy) {
-    if (use_buddy) {
-        // Calcular el tamaño total necesario
-        size_t total_size = h * sizeof(Pixel*) + h * w * sizeof(Pixel);
-        buddy_allocator = std::make_unique<BuddyAllocator>(total_size * 2); // Asignar el doble para tener margen
-        
-        // Asignar memoria para los punteros a filas
-        Pixel** rows = static_cast<Pixel**>(buddy_allocator->allocate(h * sizeof(Pixel*)));
-        if (!rows) {
-            throw std::bad_alloc();
+ImageProcessor::ImageProcessor(ImageProcessor&& other) noexcept : ImageProcessor() {
+    swap(other);
+}
+
+ImageProcessor& ImageProcessor::operator=(ImageProcessor&& other) noexcept {
+    swap(other);
+    return *this;
+}
+
+void ImageProcessor::swap(ImageProcessor& other) noexcept {
+    std::swap(width, other.width);
+    std::swap(height, other.height);
+    std::swap(channels, other.channels);
+    pixels.swap(other.pixels);
+    std::swap(allocator, other.allocator);
+    std::swap(layout, other.layout);
+    std::swap(border_mode, other.border_mode);
+    std::swap(border_apron, other.border_apron);
+    std::swap(tiled_rotation, other.tiled_rotation);
+    std::swap(output_tile, other.output_tile);
+    std::swap(tile_prefetch, other.tile_prefetch);
+    std::swap(fixed_point, other.fixed_point);
+    std::swap(rotation_engine, other.rotation_engine);
+    std::swap(interpolation, other.interpolation);
+}
+
+ImageProcessor ImageProcessor::empty_like() const {
+    ImageProcessor image;
+    image.allocator = allocator;
+    image.layout = layout;
+    image.border_mode = border_mode;
+    image.border_apron = border_apron;
+    image.tiled_rotation = tiled_rotation;
+    image.output_tile = output_tile;
+    image.tile_prefetch = tile_prefetch;
+    image.fixed_point = fixed_point;
+    image.rotation_engine = rotation_engine;
+    image.interpolation = interpolation;
+    return image;
+}
+
+ImageBuffer ImageProcessor::allocate_pixels(int w, int h, int c) const {
+    ImageBuffer buffer;
+    buffer.width = w;
+    buffer.height = h;
+    buffer.channels = c;
+    buffer.planar = (layout == Layout::Planar);
+    buffer.apron = border_apron;
+    buffer.stride = ImageBuffer::aligned_stride(buffer.margin_bytes() +
+                                                static_cast<size_t>(w + border_apron) * buffer.pixel_bytes());
+    
+    allocator.allocate(buffer);
+    buffer.release = allocator.release;
+    return buffer;
+}
+
+void ImageProcessor::free_pixels(ImageBuffer& buffer) const {
+    if (!buffer) return;
+    
+    buffer.release(buffer);
+    buffer = ImageBuffer();
+}
+
+ImageBuffer ImageProcessor::copy_pixels() const {
+    ImageBuffer copy = allocate_pixels(width, height, channels);
+    int planes = pixels.planar ? channels : 1;
+    size_t row_bytes = static_cast<size_t>(width) * pixels.pixel_bytes();
+    for (int p = 0; p < planes; ++p) {
+        ImageView in = pixels.planar ? pixels.plane(p) : pixels.view();
+        ImageView out = copy.planar ? copy.plane(p) : copy.view();
+        for (int y = 0; y < height; ++y) {
+            std::memcpy(out.row(y), in.row(y), row_bytes);
         }
-        
-        // Asignar memoria para todos los píxeles en un solo bloque
-        Pixel* pixel_block = static_cast<Pixel*>(buddy_allocator->allocate(h * w * sizeof(Pixel)));
-        if (!pixel_block) {
-            throw std::bad_alloc();
+    }
+    return copy;
+}
+
+// Índice dentro de [0, size) que ve la posición i fuera de la imagen. El
+// reflejo tiene periodo 2 * size: ... c b a | a b c | c b a ...
+template <ImageProcessor::BorderMode MODE>
+static int border_index(int i, int size) {
+    if (MODE == ImageProcessor::BorderMode::Replicate) {
+        return std::min(std::max(i, 0), size - 1);
+    }
+    int period = 2 * size;
+    int m = i % period;
+    if (m < 0) m += period;
+    return m < size ? m : period - 1 - m;
+}
+
+// Fila y de una vista, también para las filas del margen (y < 0)
+static unsigned char* margin_row(const ImageView& image, int y) {
+    return image.data + static_cast<ptrdiff_t>(y) * static_cast<ptrdiff_t>(image.stride);
+}
+
+// Rellena el margen de una imagen intercalada o de un plano: primero los
+// lados de cada fila y después las filas de arriba y abajo completas, que así
+// incluyen las esquinas. Especializado por bytes por píxel y modo, de modo
+// que cada copia de píxel es de tamaño fijo y el bucle no consulta el modo.
+template <int C, ImageProcessor::BorderMode MODE>
+static void fill_border(const ImageView& image, int apron, const unsigned char* fill) {
+    const bool constant = MODE == ImageProcessor::BorderMode::Constant;
+    size_t row_bytes = static_cast<size_t>(image.width + 2 * apron) * C;
+    
+    for (int y = 0; y < image.height; ++y) {
+        unsigned char* row = margin_row(image, y);
+        for (int x = -apron; x < image.width + apron; ++x) {
+            if (x == 0) x = image.width;
+            const unsigned char* from = constant ? fill : row + border_index<MODE>(x, image.width) * C;
+            std::memcpy(row + x * C, from, C);
         }
-        
-        // Configurar los punteros a filas
-        for (int y = 0; y < h; ++y) {
-            rows[y] = pixel_block + y * w;
+    }
+    
+    for (int y = -apron; y < image.height + apron; ++y) {
+        if (y == 0) y = image.height;
+        unsigned char* row = margin_row(image, y) - apron * C;
+        if (constant) {
+            for (size_t i = 0; i < row_bytes; i += C) {
+                std::memcpy(row + i, fill, C);
+            }
+        } else {
+            const unsigned char* from = margin_row(image, border_index<MODE>(y, image.height));
+            std::memcpy(row, from - apron * C, row_bytes);
         }
-        
-        return rows;
-    } else {
-        // Asignación convencional
-        Pixel** rows = new Pixel*[h];
-        for (int y = 0; y < h; ++y) {
-            rows[y] = new Pixel[w];
+    }
+}
+
+typedef void (*BorderKernel)(const ImageView&, int, const unsigned char*);
+
+// Tabla [modo][bytes por píxel - 1]
+static BorderKernel select_border(ImageProcessor::BorderMode mode, int pixel_bytes) {
+    typedef ImageProcessor::BorderMode Mode;
+    static const BorderKernel kernels[3][4] = {
+        {fill_border<1, Mode::Constant>, fill_border<2, Mode::Constant>,
+         fill_border<3, Mode::Constant>, fill_border<4, Mode::Constant>},
+        {fill_border<1, Mode::Replicate>, fill_border<2, Mode::Replicate>,
+         fill_border<3, Mode::Replicate>, fill_border<4, Mode::Replicate>},
+        {fill_border<1, Mode::Reflect>, fill_border<2, Mode::Reflect>,
+         fill_border<3, Mode::Reflect>, fill_border<4, Mode::Reflect>}};
+    return kernels[static_cast<int>(mode)][pixel_bytes - 1];
+}
+
+ImageBuffer ImageProcessor::bordered_source(const ImageBuffer& src, const unsigned char* fill) const {
+    if (src.apron > 0) {
+        if (src.planar) {
+            BorderKernel kernel = select_border(border_mode, 1);
+            for (int c = 0; c < src.channels; ++c) {
+                kernel(src.plane(c), src.apron, &fill[c]);
+            }
+        } else {
+            select_border(border_mode, src.channels)(src.view(), src.apron, fill);
         }
-        return rows;
     }
+    return src.padded();
 }
 
-void ImageProcessor::free_pixels(Pixel** ptr, int h, bool use_buddy) {
-    if (use_buddy) {
-        // Buddy System maneja la liberación automáticamente en su destructor
-        buddy_allocator.reset();
-    } else {
-        // Liberación convencional
-        for (int y = 0; y < h; ++y) {
-            delete[] ptr[y];
+// Conversión entre píxeles intercalados y planos, especializada por número de
+// canales: cada fila se recorre una sola vez repartiendo (o juntando) todos
+// los canales, con el reparto desenrollado en tiempo de compilación
+template <int C>
+static void deinterleave_row(const unsigned char* src, unsigned char* const* planes, int width) {
+    for (int x = 0; x < width; ++x) {
+        for (int c = 0; c < C; ++c) {
+            planes[c][x] = src[x * C + c];
         }
-        delete[] ptr;
     }
 }
 
-bool ImageProcessor::load_image(const std::string& filename, bool use_buddy) {
-    if (pixels) {
-        free_pixels(pixels, height, using_buddy);
-        pixels = nullptr;
+template <int C>
+static void interleave_row(const unsigned char* const* planes, unsigned char* dst, int width) {
+    for (int x = 0; x < width; ++x) {
+        for (int c = 0; c < C; ++c) {
+            dst[x * C + c] = planes[c][x];
+        }
     }
+}
+
+typedef void (*DeinterleaveKernel)(const unsigned char*, unsigned char* const*, int);
+typedef void (*InterleaveKernel)(const unsigned char* const*, unsigned char*, int);
+
+// Tablas [canales - 1]
+static const DeinterleaveKernel deinterleave_kernels[4] = {
+    deinterleave_row<1>, deinterleave_row<2>, deinterleave_row<3>, deinterleave_row<4>};
+static const InterleaveKernel interleave_kernels[4] = {
+    interleave_row<1>, interleave_row<2>, interleave_row<3>, interleave_row<4>};
+
+bool ImageProcessor::load_image(const std::string& filename) {
+    free_pixels(pixels);
 
     unsigned char* data = stbi_load(filename.c_str(), &width, &height, &channels, 0);
     if (!data) {
@@ -77,19 +224,24 @@ bool ImageProcessor::load_image(const std::string& filename, bool use_buddy) {
         return false;
     }
 
-    using_buddy = use_buddy;
-    
     try {
-        pixels = allocate_pixels(width, height, use_buddy);
+        pixels = allocate_pixels(width, height, channels);
         
-        // Copiar datos
-        for (int y = 0; y < height; ++y) {
-            for (int x = 0; x < width; ++x) {
-                int index = (y * width + x) * channels;
-                pixels[y][x].r = data[index];
-                pixels[y][x].g = data[index + 1];
-                pixels[y][x].b = data[index + 2];
-                pixels[y][x].a = (channels == 4) ? data[index + 3] : 255;
+        // Copiar datos fila a fila, conservando el número de canales original
+        size_t row_bytes = static_cast<size_t>(width) * channels;
+        if (pixels.planar) {
+            // Separar los canales intercalados en un plano por canal
+            DeinterleaveKernel kernel = deinterleave_kernels[channels - 1];
+            unsigned char* planes[4];
+            for (int y = 0; y < height; ++y) {
+                for (int c = 0; c < channels; ++c) {
+                    planes[c] = pixels.plane(c).row(y);
+                }
+                kernel(data + y * row_bytes, planes, width);
+            }
+        } else {
+            for (int y = 0; y < height; ++y) {
+                std::memcpy(pixels.row(y), data + y * row_bytes, row_bytes);
             }
         }
         
@@ -104,100 +256,341 @@ bool ImageProcessor::load_image(const std::string& filename, bool use_buddy) {
 bool ImageProcessor::save_image(const std::string& filename) const {
     if (!pixels) return false;
     
-    // Convertir nuestra estructura a un buffer plano
-    unsigned char* data = new unsigned char[width * height * channels];
-    
-    for (int y = 0; y < height; ++y) {
-        for (int x = 0; x < width; ++x) {
-            int index = (y * width + x) * channels;
-            data[index] = pixels[y][x].r;
-            data[index + 1] = pixels[y][x].g;
-            data[index + 2] = pixels[y][x].b;
-            if (channels == 4) {
-                data[index + 3] = pixels[y][x].a;
+    std::string extension = filename.substr(filename.find_last_of(".") + 1);
+    size_t row_bytes = static_cast<size_t>(width) * channels;
+    
+    // Los escritores de stb esperan píxeles intercalados. PNG acepta un stride,
+    // así que en modo intercalado se escribe desde el propio buffer; JPG
+    // necesita filas empaquetadas y el modo planar necesita volver a intercalar.
+    const unsigned char* out = pixels.data;
+    size_t out_stride = pixels.stride;
+    std::vector<unsigned char> packed;
+    if (pixels.planar || (extension != "png" && pixels.stride != row_bytes)) {
+        packed.resize(row_bytes * height);
+        InterleaveKernel kernel = interleave_kernels[channels - 1];
+        const unsigned char* planes[4];
+        for (int y = 0; y < height; ++y) {
+            unsigned char* dst = &packed[y * row_bytes];
+            if (pixels.planar) {
+                for (int c = 0; c < channels; ++c) {
+                    planes[c] = pixels.plane(c).row(y);
+                }
+                kernel(planes, dst, width);
+            } else {
+                std::memcpy(dst, pixels.row(y), row_bytes);
             }
         }
+        out = packed.data();
+        out_stride = row_bytes;
     }
     
     // Guardar la imagen
     bool success = false;
-    if (filename.substr(filename.find_last_of(".") + 1) == "png") {
-        success = stbi_write_png(filename.c_str(), width, height, channels, data, width * channels);
-    } else if (filename.substr(filename.find_last_of(".") + 1) == "jpg" || 
-               filename.substr(filename.find_last_of(".") + 1) == "jpeg") {
-        success = stbi_write_jpg(filename.c_str(), width, height, channels, data, 90);
+    if (extension == "png") {
+        success = stbi_write_png(filename.c_str(), width, height, channels,
+                                 out, static_cast<int>(out_stride));
+    } else if (extension == "jpg" || extension == "jpeg") {
+        success = stbi_write_jpg(filename.c_str(), width, height, channels, out, 90);
     } else {
         std::cerr << "Formato de archivo no soportado" << std::endl;
     }
     
-    delete[] data;
     return success;
 }
 
-ImageProcessor::Pixel ImageProcessor::interpolate(double x, double y) const {
+// Referencia: mezcla en doble precisión con truncamiento final
+struct ImageProcessor::DoubleBlend {
+    static const bool FIXED = false;
+    
+    template <int C>
+    static void apply(const unsigned char* p00, const unsigned char* p10,
+                      const unsigned char* p01, const unsigned char* p11,
+                      double dx, double dy, unsigned char* out) {
+        // Interpolación bilineal, solo sobre los canales presentes
+        for (int c = 0; c < C; ++c) {
+            out[c] = static_cast<unsigned char>(
+                p00[c] * (1 - dx) * (1 - dy) + 
+                p10[c] * dx * (1 - dy) + 
+                p01[c] * (1 - dx) * dy + 
+                p11[c] * dx * dy
+            );
+        }
+    }
+};
+
+// Punto fijo: los pesos se redondean a 8 bits fraccionarios (0..256) y la
+// mezcla se hace en dos interpolaciones lineales enteras (horizontal en 16
+// bits, vertical en 32). Redondear los pesos limita el error de cada eje a
+// 1/512 de píxel, así que el valor antes de truncar se aparta menos de 1 de
+// la referencia y el resultado difiere como mucho en 1 LSB.
+struct ImageProcessor::FixedBlend {
+    static const bool FIXED = true;
+    static const int BITS = 8;
+    static const int ONE = 1 << BITS;
+    
+    static int weight(double d) {
+        return static_cast<int>(d * ONE + 0.5);
+    }
+    
+    template <int C>
+    static void apply(const unsigned char* p00, const unsigned char* p10,
+                      const unsigned char* p01, const unsigned char* p11,
+                      double dx, double dy, unsigned char* out) {
+        int fx = weight(dx);
+        int fy = weight(dy);
+        for (int c = 0; c < C; ++c) {
+            int top = p00[c] * (ONE - fx) + p10[c] * fx;
+            int bottom = p01[c] * (ONE - fx) + p11[c] * fx;
+            out[c] = static_cast<unsigned char>((top * (ONE - fy) + bottom * fy) >> (2 * BITS));
+        }
+    }
+};
+
+// Muestreo sin acotar para el interior de un tramo recortado: requiere
+// 0 <= x < ancho - 1 y 0 <= y < alto - 1, de modo que los cuatro vecinos existen
+template <int C, class Blend>
+void ImageProcessor::sample(const ImageView& src, double x, double y, unsigned char* out) {
+    int x0 = static_cast<int>(x);
+    int y0 = static_cast<int>(y);
+    
+    const unsigned char* p00 = src.row(y0) + x0 * C;
+    const unsigned char* p01 = p00 + src.stride;
+    
+    Blend::template apply<C>(p00, p00 + C, p01, p01 + C, x - x0, y - y0, out);
+}
+
+// Variante sobre teselas: los cuatro vecinos están en la misma tesela
+template <int C, class Blend>
+void ImageProcessor::sample(const TiledImage& src, double x, double y, unsigned char* out) {
     int x0 = static_cast<int>(x);
     int y0 = static_cast<int>(y);
-    int x1 = x0 + 1;
-    int y1 = y0 + 1;
-    
-    // Asegurarnos de que estamos dentro de los límites
-    x0 = std::max(0, std::min(width - 1, x0));
-    y0 = std::max(0, std::min(height - 1, y0));
-    x1 = std::max(0, std::min(width - 1, x1));
-    y1 = std::max(0, std::min(height - 1, y1));
-    
-    double dx = x - x0;
-    double dy = y - y0;
-    
-    Pixel p00 = get_pixel(x0, y0);
-    Pixel p01 = get_pixel(x0, y1);
-    Pixel p10 = get_pixel(x1, y0);
-    Pixel p11 = get_pixel(x1, y1);
-    
-    // Interpolación bilineal
-    Pixel result;
-    result.r = static_cast<unsigned char>(
-        p00.r * (1 - dx) * (1 - dy) + 
-        p10.r * dx * (1 - dy) + 
-        p01.r * (1 - dx) * dy + 
-        p11.r * dx * dy
-    );
-    
-    result.g = static_cast<unsigned char>(
-        p00.g * (1 - dx) * (1 - dy) + 
-        p10.g * dx * (1 - dy) + 
-        p01.g * (1 - dx) * dy + 
-        p11.g * dx * dy
-    );
-    
-    result.b = static_cast<unsigned char>(
-        p00.b * (1 - dx) * (1 - dy) + 
-        p10.b * dx * (1 - dy) + 
-        p01.b * (1 - dx) * dy + 
-        p11.b * dx * dy
-    );
-    
-    result.a = static_cast<unsigned char>(
-        p00.a * (1 - dx) * (1 - dy) + 
-        p10.a * dx * (1 - dy) + 
-        p01.a * (1 - dx) * dy + 
-        p11.a * dx * dy
-    );
     
-    return result;
+    const unsigned char* p00 = src.pixel(x0, y0);
+    const unsigned char* p01 = p00 + src.row_bytes();
+    
+    Blend::template apply<C>(p00, p00 + C, p01, p01 + C, x - x0, y - y0, out);
 }
 
-ImageProcessor::Pixel ImageProcessor::get_pixel(int x, int y) const {
-    if (x < 0 || x >= width || y < 0 || y >= height) {
-        return Pixel{0, 0, 0, 0}; // Pixel negro para coordenadas fuera de límites
+// Prefijo vectorizado de un tramo de muestras; el resto lo completa el
+// muestreo escalar. Las teselas no tienen núcleo vectorizado.
+template <class Blend>
+static int sample_span(const ImageView& src, double x, double y, double step_x, double step_y,
+                       int count, unsigned char* out) {
+    BilinearSpan span = {src, x, y, step_x, step_y, count, out};
+    return bilinear_span(span, Blend::FIXED);
+}
+
+template <class Blend>
+static int sample_span(const TiledImage&, double, double, double, double, int, unsigned char*) {
+    return 0;
+}
+
+// Variante proyectiva: el punto i es ((x + i * step_x) / (w + i * step_w),
+// (y + i * step_y) / (w + i * step_w))
+template <class Blend>
+static int sample_span(const ImageView& src, double x, double y, double w, double step_x,
+                       double step_y, double step_w, int count, unsigned char* out) {
+    BilinearSpan span = {src, x, y, step_x, step_y, count, out, w, step_w};
+    return bilinear_span(span, Blend::FIXED);
+}
+
+template <class Blend>
+static int sample_span(const TiledImage&, double, double, double, double, double, double, int,
+                       unsigned char*) {
+    return 0;
+}
+
+// Dimensiones del origen de una rotación (imagen lineal o en teselas)
+static int source_width(const ImageView& src) { return src.width; }
+static int source_height(const ImageView& src) { return src.height; }
+static int source_width(const TiledImage& src) { return src.get_width(); }
+static int source_height(const TiledImage& src) { return src.get_height(); }
+
+// Color de relleno RGBA reducido a los canales de la imagen
+static void fill_for_channels(const ImageProcessor::Pixel& color, int channels, unsigned char* out) {
+    switch (channels) {
+        case 1: out[0] = color.r; break;
+        case 2: out[0] = color.r; out[1] = color.a; break;
+        case 3: out[0] = color.r; out[1] = color.g; out[2] = color.b; break;
+        default: out[0] = color.r; out[1] = color.g; out[2] = color.b; out[3] = color.a; break;
     }
-    return pixels[y][x];
 }
 
-void ImageProcessor::set_pixel(int x, int y, const Pixel& pixel) {
-    if (x >= 0 && x < width && y >= 0 && y < height) {
-        pixels[y][x] = pixel;
+// Recorta [begin, end) a los x enteros con 0 <= origin + x * step < limit
+static void clip_axis(double origin, double step, double limit, int& begin, int& end) {
+    double lo, hi;
+    if (step > 0) {
+        lo = std::ceil(-origin / step);
+        hi = std::ceil((limit - origin) / step);
+    } else if (step < 0) {
+        lo = std::floor((limit - origin) / step) + 1;
+        hi = std::floor(-origin / step) + 1;
+    } else {
+        if (origin < 0 || origin >= limit) end = begin;
+        return;
     }
+    if (lo > begin) begin = static_cast<int>(std::min(lo, static_cast<double>(end)));
+    if (hi < end) end = static_cast<int>(std::max(hi, static_cast<double>(begin)));
+}
+
+// Corrige los extremos de un recorte analítico con el predicado exacto
+// del muestreador: el interior válido es un intervalo
+template <class Inside>
+static void refine_span(const Inside& inside, int dst_width, int& begin, int& end) {
+    while (begin < end && !inside(begin)) ++begin;
+    while (end > begin && !inside(end - 1)) --end;
+    if (begin < end) {
+        while (begin > 0 && inside(begin - 1)) --begin;
+        while (end < dst_width && inside(end)) ++end;
+    }
+}
+
+// Tramo [begin, end) de una fila de salida cuyos puntos de origen
+// (origin_x + x * step_x, origin_y + x * step_y) tienen sus cuatro vecinos
+// bilineales dentro de la imagen: 0 <= sx < ancho - 1 y 0 <= sy < alto - 1.
+// Tras la solución analítica se corrigen los extremos evaluando exactamente la
+// misma expresión que usará el muestreador, para que el redondeo de las
+// divisiones no deje fuera (ni meta) ningún píxel del borde.
+static void clip_span(double origin_x, double origin_y, double step_x, double step_y,
+                      int src_width, int src_height, int dst_width, int& begin, int& end) {
+    double limit_x = src_width - 1;
+    double limit_y = src_height - 1;
+    auto inside = [&](int x) {
+        double sx = origin_x + x * step_x;
+        double sy = origin_y + x * step_y;
+        return sx >= 0 && sx < limit_x && sy >= 0 && sy < limit_y;
+    };
+    
+    begin = 0;
+    end = dst_width;
+    clip_axis(origin_x, step_x, limit_x, begin, end);
+    clip_axis(origin_y, step_y, limit_y, begin, end);
+    
+    refine_span(inside, dst_width, begin, end);
+}
+
+// Recorta [begin, end) a los x enteros con origin + x * step > 0
+static void clip_positive(double origin, double step, int& begin, int& end) {
+    if (step > 0) {
+        double lo = std::floor(-origin / step) + 1;
+        if (lo > begin) begin = static_cast<int>(std::min(lo, static_cast<double>(end)));
+    } else if (step < 0) {
+        double hi = std::ceil(-origin / step);
+        if (hi < end) end = static_cast<int>(std::max(hi, static_cast<double>(begin)));
+    } else if (origin <= 0) {
+        end = begin;
+    }
+}
+
+// Equivalente de clip_span para una homografía: el punto de origen del
+// píxel x es (X, Y) / W con numeradores y denominador lineales en x. Con
+// W > 0 las condiciones 0 <= X / W < ancho - 1 se reducen a X >= 0 y
+// (ancho - 1) * W - X > 0, también lineales, y el tramo válido sigue siendo
+// un intervalo. Los extremos se corrigen igual que en clip_span, con la
+// misma expresión (un recíproco y dos productos) que usa el muestreador.
+static void clip_projective(double origin_x, double origin_y, double origin_w,
+                            double step_x, double step_y, double step_w,
+                            int src_width, int src_height, int dst_width, int& begin, int& end) {
+    double limit_x = src_width - 1;
+    double limit_y = src_height - 1;
+    auto inside = [&](int x) {
+        double w = origin_w + x * step_w;
+        if (!(w > 0)) return false;
+        double inverse = 1.0 / w;
+        double sx = (origin_x + x * step_x) * inverse;
+        double sy = (origin_y + x * step_y) * inverse;
+        return sx >= 0 && sx < limit_x && sy >= 0 && sy < limit_y;
+    };
+    
+    begin = 0;
+    end = dst_width;
+    clip_positive(origin_w, step_w, begin, end);
+    clip_positive(origin_x, step_x, begin, end);
+    clip_positive(origin_y, step_y, begin, end);
+    clip_positive(limit_x * origin_w - origin_x, limit_x * step_w - step_x, begin, end);
+    clip_positive(limit_y * origin_w - origin_y, limit_y * step_w - step_y, begin, end);
+    
+    refine_span(inside, dst_width, begin, end);
+}
+
+// Rellena los píxeles [begin, end) de una fila con el color de fondo
+template <int C>
+static void fill_run(unsigned char* row, int begin, int end, const unsigned char* fill) {
+    for (int x = begin; x < end; ++x) {
+        for (int c = 0; c < C; ++c) {
+            row[x * C + c] = fill[c];
+        }
+    }
+}
+
+// Recorrido de la salida: filas completas (tile <= 0) o teselas cuadradas
+// de tile x tile píxeles, por filas de teselas. segment(y, x_begin, x_end,
+// next_end) produce el tramo [x_begin, x_end) de la fila y; [x_end,
+// next_end) es el tramo de la misma fila en la tesela siguiente, que el
+// núcleo puede adelantar a la caché (vacío al recorrer por filas).
+template <class Segment>
+static void traverse_output(int width, int height, int tile, const Segment& segment) {
+    if (tile <= 0) {
+        for (int y = 0; y < height; ++y) {
+            segment(y, 0, width, width);
+        }
+        return;
+    }
+    for (int tile_y = 0; tile_y < height; tile_y += tile) {
+        int y_end = std::min(tile_y + tile, height);
+        for (int tile_x = 0; tile_x < width; tile_x += tile) {
+            int x_end = std::min(tile_x + tile, width);
+            int next_end = std::min(x_end + tile, width);
+            for (int y = tile_y; y < y_end; ++y) {
+                segment(y, tile_x, x_end, next_end);
+            }
+        }
+    }
+}
+
+// Los núcleos vectorizados recorren el tramo en bloques de hasta 16 píxeles
+// (y warp_plane en bloques de PLANE_BLOCK) a partir de su primer píxel
+static const int SPAN_BLOCK = 16;
+
+// Parte [begin, end) del tramo válido [row_begin, row_end) de una fila que
+// muestrea el trozo [x_begin, x_end). Los cortes se ajustan a la rejilla de
+// SPAN_BLOCK píxeles que empieza en row_begin: cada trozo muestrea los
+// bloques que empiezan en él (el que cruza el borde de la tesela se completa
+// aquí), así que bloques y resto escalar son los mismos que al recorrer la
+// fila entera y el resultado no depende del tamaño de tesela.
+static void segment_span(int row_begin, int row_end, int x_begin, int x_end, int width,
+                         int& begin, int& end) {
+    auto snap = [&](int x) {
+        if (x <= row_begin) return row_begin;
+        if (x >= width) return row_end;
+        int aligned = row_begin + (x - row_begin + SPAN_BLOCK - 1) / SPAN_BLOCK * SPAN_BLOCK;
+        return std::min(aligned, row_end);
+    };
+    begin = snap(x_begin);
+    end = std::max(snap(x_end), begin);
+}
+
+// Separación en píxeles de salida entre las pistas de prefetch de un tramo.
+// Una pista por cada línea de caché que cruza el tramo repetiría casi todas
+// las de la fila anterior (filas consecutivas de salida se desplazan una
+// fila de origen), así que se reparten unas pocas por tramo y el resto lo
+// completa el prefetcher hardware al seguir cada fila de origen.
+static int prefetch_gap(int tile) {
+    return std::max(SPAN_BLOCK, tile / 4);
+}
+
+// Adelanta las líneas de los cuatro vecinos del punto (sx, sy), que debe
+// estar dentro del tramo recortado
+static inline void prefetch_source(const ImageView& src, double sx, double sy) {
+    const unsigned char* p = src.row(static_cast<int>(sy)) + static_cast<int>(sx) * src.channels;
+    __builtin_prefetch(p);
+    __builtin_prefetch(p + src.stride);
+}
+
+static inline void prefetch_source(const TiledImage& src, double sx, double sy) {
+    const unsigned char* p = src.pixel(static_cast<int>(sx), static_cast<int>(sy));
+    __builtin_prefetch(p);
+    __builtin_prefetch(p + src.row_bytes());
 }
 
 void ImageProcessor::rotate(double angle, unsigned char fill_r, unsigned char fill_g, 
@@ -206,7 +599,15 @@ void ImageProcessor::rotate(double angle, unsigned char fill_r, unsigned char fi
     
     auto start = std::chrono::high_resolution_clock::now();
     
-    rotate_internal(angle, fill_r, fill_g, fill_b, fill_a);
+    // Los múltiplos de 90 grados son una permutación exacta de píxeles: sin
+    // interpolación, sin relleno y con las dimensiones intercambiadas
+    double turns = angle / 90.0;
+    if (turns == std::floor(turns)) {
+        int quarter = static_cast<int>(std::fmod(turns, 4.0));
+        rotate_right_angle(quarter < 0 ? quarter + 4 : quarter);
+    } else {
+        *this = rotated(angle, fill_r, fill_g, fill_b, fill_a);
+    }
     
     auto end = std::chrono::high_resolution_clock::now();
     auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
@@ -214,47 +615,1181 @@ void ImageProcessor::rotate(double angle, unsigned char fill_r, unsigned char fi
     std::cout << "Rotación completada en " << duration.count() << " ms" << std::endl;
 }
 
-void ImageProcessor::rotate_internal(double angle, unsigned char fill_r, unsigned char fill_g, 
-                                    unsigned char fill_b, unsigned char fill_a) {
-    // Convertir ángulo a radianes
-    double radians = angle * M_PI / 180.0;
+ImageProcessor ImageProcessor::rotated(double angle, unsigned char fill_r, unsigned char fill_g,
+                                       unsigned char fill_b, unsigned char fill_a) const {
+    ImageProcessor result = empty_like();
+    if (!pixels) return result;
+    
+    double turns = angle / 90.0;
+    if (turns == std::floor(turns)) {
+        int quarter = static_cast<int>(std::fmod(turns, 4.0));
+        if (quarter < 0) quarter += 4;
+        if (quarter % 2 == 1) {
+            result.pixels = quarter_turn(quarter);
+        } else {
+            result.pixels = copy_pixels();
+            if (quarter == 2) half_turn(result.pixels);
+        }
+    } else {
+        unsigned char fill[4];
+        fill_for_channels(Pixel{fill_r, fill_g, fill_b, fill_a}, channels, fill);
+        result.pixels = rotate_internal(angle, fill);
+    }
+    
+    result.width = result.pixels.width;
+    result.height = result.pixels.height;
+    result.channels = channels;
+    return result;
+}
+
+// 180 grados en el sitio: la fila y se intercambia con la fila (alto - 1 - y)
+// recorriendo una hacia delante y otra hacia atrás
+template <int C>
+void ImageProcessor::rotate_half_turn(const ImageView& image) {
+    for (int y = 0; y < (image.height + 1) / 2; ++y) {
+        unsigned char* front = image.row(y);
+        unsigned char* back = image.row(image.height - 1 - y) + (image.width - 1) * C;
+        
+        // La fila central (alto impar) solo se recorre hasta la mitad
+        int count = (y == image.height - 1 - y) ? image.width / 2 : image.width;
+        for (int x = 0; x < count; ++x) {
+            unsigned char pixel[C];
+            std::memcpy(pixel, front, C);
+            std::memcpy(front, back, C);
+            std::memcpy(back, pixel, C);
+            front += C;
+            back -= C;
+        }
+    }
+}
+
+// Bloques de destino que se copian directamente en la transposición
+static const int TRANSPOSE_LEAF = 32;
+
+// 90 (turns = 1) o 270 grados (turns = 3) sobre el rectángulo de destino
+// [x_begin, x_end) x [y_begin, y_end). Se divide recursivamente por el lado
+// más largo hasta bloques de TRANSPOSE_LEAF x TRANSPOSE_LEAF, de modo que las
+// filas de origen y destino que toca cada bloque caben en caché sea cual sea
+// su tamaño. Con dst de alto = ancho de src y ancho = alto de src:
+//   90:  dst(x, y) = src(y, alto - 1 - x)
+//   270: dst(x, y) = src(ancho - 1 - y, x)
+template <int C>
+void ImageProcessor::rotate_quarter(const ImageView& src, const ImageView& dst, int turns,
+                                    int x_begin, int x_end, int y_begin, int y_end) {
+    int w = x_end - x_begin;
+    int h = y_end - y_begin;
+    if (w > TRANSPOSE_LEAF || h > TRANSPOSE_LEAF) {
+        if (w >= h) {
+            int x_mid = x_begin + w / 2;
+            rotate_quarter<C>(src, dst, turns, x_begin, x_mid, y_begin, y_end);
+            rotate_quarter<C>(src, dst, turns, x_mid, x_end, y_begin, y_end);
+        } else {
+            int y_mid = y_begin + h / 2;
+            rotate_quarter<C>(src, dst, turns, x_begin, x_end, y_begin, y_mid);
+            rotate_quarter<C>(src, dst, turns, x_begin, x_end, y_mid, y_end);
+        }
+        return;
+    }
+    
+    // Cada fila de destino recorre una columna del origen
+    for (int y = y_begin; y < y_end; ++y) {
+        unsigned char* out = dst.row(y) + x_begin * C;
+        const unsigned char* in;
+        ptrdiff_t step;
+        if (turns == 1) {
+            in = src.row(src.height - 1 - x_begin) + y * C;
+            step = -static_cast<ptrdiff_t>(src.stride);
+        } else {
+            in = src.row(x_begin) + (src.width - 1 - y) * C;
+            step = static_cast<ptrdiff_t>(src.stride);
+        }
+        for (int x = x_begin; x < x_end; ++x) {
+            std::memcpy(out, in, C);
+            out += C;
+            in += step;
+        }
+    }
+}
+
+void ImageProcessor::half_turn(const ImageBuffer& image) {
+    int planes = image.planar ? image.channels : 1;
+    for (int p = 0; p < planes; ++p) {
+        ImageView view = image.planar ? image.plane(p) : image.view();
+        switch (image.pixel_bytes()) {
+            case 1: rotate_half_turn<1>(view); break;
+            case 2: rotate_half_turn<2>(view); break;
+            case 3: rotate_half_turn<3>(view); break;
+            default: rotate_half_turn<4>(view); break;
+        }
+    }
+}
+
+// 90 y 270 grados intercambian ancho y alto
+ImageBuffer ImageProcessor::quarter_turn(int turns) const {
+    int planes = pixels.planar ? channels : 1;
+    int pixel_bytes = pixels.pixel_bytes();
+    
+    ImageBuffer rotated = allocate_pixels(height, width, channels);
+    for (int p = 0; p < planes; ++p) {
+        ImageView in = pixels.planar ? pixels.plane(p) : pixels.view();
+        ImageView out = rotated.planar ? rotated.plane(p) : rotated.view();
+        switch (pixel_bytes) {
+            case 1: rotate_quarter<1>(in, out, turns, 0, out.width, 0, out.height); break;
+            case 2: rotate_quarter<2>(in, out, turns, 0, out.width, 0, out.height); break;
+            case 3: rotate_quarter<3>(in, out, turns, 0, out.width, 0, out.height); break;
+            default: rotate_quarter<4>(in, out, turns, 0, out.width, 0, out.height); break;
+        }
+    }
+    return rotated;
+}
+
+void ImageProcessor::rotate_right_angle(int turns) {
+    if (turns == 0) return;
+    
+    // Media vuelta en el sitio, sin buffer nuevo
+    if (turns == 2) {
+        half_turn(pixels);
+        return;
+    }
+    
+    ImageBuffer rotated = quarter_turn(turns);
+    std::swap(width, height);
+    free_pixels(pixels);
+    pixels = std::move(rotated);
+}
+
+template <int C, class Blend, class Source>
+void ImageProcessor::warp_kernel(const Source& src, const ImageView& dst,
+                                 const AffineTransform& inverse, const unsigned char* fill,
+                                 int tile, bool prefetch, bool stream) {
+    int src_width = source_width(src);
+    int src_height = source_height(src);
+    
+    // Para cada fila, el origen del píxel x es (origin_x + x * a, origin_y + x * c)
+    // con la transformación inversa: la matriz se evalúa una vez por fila.
+    // Se recorta analíticamente el tramo válido: solo los dos segmentos de
+    // borde reciben el color de fondo y el interior se muestrea sin comprobar
+    // límites. La posición se evalúa como origen + x * incremento (sin
+    // acumular) para coincidir exactamente con el recorte.
+    double step_x = inverse.a;
+    double step_y = inverse.c;
+    std::vector<int> spans(2 * static_cast<size_t>(dst.height));
+    for (int y = 0; y < dst.height; ++y) {
+        double origin_x = inverse.tx + y * inverse.b;
+        double origin_y = inverse.ty + y * inverse.d;
+        clip_span(origin_x, origin_y, step_x, step_y, src_width, src_height, dst.width,
+                  spans[2 * y], spans[2 * y + 1]);
+    }
+    
+    // Al recorrer por teselas cada fila se produce a trozos; tras cada trozo
+    // se adelantan las líneas de origen del trozo de la tesela siguiente
+    // Con escritura no temporal cada trozo se compone en la fila intermedia
+    // y se vuelca en sus tres partes (fondo, muestras, fondo)
+    int gap = prefetch_gap(tile);
+    OutputRows rows(dst, stream);
+    auto segment = [&](int y, int x_begin, int x_end, int next_end) {
+        unsigned char* row = rows.row(y);
+        double origin_x = inverse.tx + y * inverse.b;
+        double origin_y = inverse.ty + y * inverse.d;
+        int row_begin = spans[2 * y];
+        int row_end = spans[2 * y + 1];
+        
+        int left = std::min(std::max(row_begin, x_begin), x_end);
+        fill_run<C>(row, x_begin, left, fill);
+        int begin, end;
+        segment_span(row_begin, row_end, x_begin, x_end, dst.width, begin, end);
+        int x = begin + sample_span<Blend>(src, origin_x + begin * step_x, origin_y + begin * step_y,
+                                           step_x, step_y, end - begin, row + begin * C);
+        for (; x < end; ++x) {
+            sample<C, Blend>(src, origin_x + x * step_x, origin_y + x * step_y, row + x * C);
+        }
+        int right = std::max(std::min(row_end, x_end), x_begin);
+        fill_run<C>(row, right, x_end, fill);
+        
+        if (rows.streaming()) {
+            rows.commit(y, x_begin * C, left * C);
+            rows.commit(y, begin * C, end * C);
+            rows.commit(y, right * C, x_end * C);
+        }
+        
+        if (prefetch) {
+            int next_begin;
+            segment_span(row_begin, row_end, x_end, next_end, dst.width, next_begin, end);
+            for (int p = next_begin; p < end; p += gap) {
+                prefetch_source(src, origin_x + p * step_x, origin_y + p * step_y);
+            }
+        }
+    };
+    traverse_output(dst.width, dst.height, tile, segment);
+}
+
+template <class Blend>
+void ImageProcessor::render_warp(const ImageBuffer& src, ImageBuffer& dst,
+                                 const AffineTransform& inverse, const unsigned char* fill) const {
+    render_warp<Blend>(src, dst, inverse, fill, output_tile, tile_prefetch);
+}
+
+template <class Blend>
+void ImageProcessor::render_warp(const ImageBuffer& src, ImageBuffer& dst,
+                                 const AffineTransform& inverse, const unsigned char* fill,
+                                 int tile, bool prefetch) const {
+    prefetch = prefetch && tile > 0;
+    bool stream = streaming_output(dst.size_bytes());
+    
+    if (src.planar && tiled_rotation) {
+        // Cada plano se convierte a teselas de un canal y se transforma por separado
+        TiledImage tiled;
+        for (int c = 0; c < src.channels; ++c) {
+            tiled.from_view(src.plane(c));
+            warp_kernel<1, Blend>(tiled, dst.plane(c), inverse, &fill[c], tile, prefetch, stream);
+        }
+    } else if (src.planar) {
+        for (int c = 0; c < src.channels; ++c) {
+            warp_plane<Blend>(src.plane(c), dst.plane(c), inverse, fill[c], tile, prefetch, stream);
+        }
+    } else if (tiled_rotation) {
+        TiledImage tiled;
+        tiled.from_view(src.view());
+        ImageView out = dst.view();
+        switch (src.channels) {
+            case 1: warp_kernel<1, Blend>(tiled, out, inverse, fill, tile, prefetch, stream); break;
+            case 2: warp_kernel<2, Blend>(tiled, out, inverse, fill, tile, prefetch, stream); break;
+            case 3: warp_kernel<3, Blend>(tiled, out, inverse, fill, tile, prefetch, stream); break;
+            default: warp_kernel<4, Blend>(tiled, out, inverse, fill, tile, prefetch, stream); break;
+        }
+    } else {
+        ImageView in = src.view();
+        ImageView out = dst.view();
+        switch (src.channels) {
+            case 1: warp_kernel<1, Blend>(in, out, inverse, fill, tile, prefetch, stream); break;
+            case 2: warp_kernel<2, Blend>(in, out, inverse, fill, tile, prefetch, stream); break;
+            case 3: warp_kernel<3, Blend>(in, out, inverse, fill, tile, prefetch, stream); break;
+            default: warp_kernel<4, Blend>(in, out, inverse, fill, tile, prefetch, stream); break;
+        }
+    }
+}
+
+template <int C, class Blend, class Source>
+void ImageProcessor::perspective_kernel(const Source& src, const ImageView& dst,
+                                        const Homography& inverse, const unsigned char* fill) {
+    int src_width = source_width(src);
+    int src_height = source_height(src);
+    const double* h = inverse.h;
+    
+    // Como en warp_kernel, la matriz se evalúa una vez por fila: a lo largo
+    // de la fila los numeradores X, Y y el denominador W crecen linealmente
+    // (h[0], h[3] y h[6] por píxel), así que cada píxel cuesta tres sumas
+    // con producto, un recíproco y dos productos. El recorte deja W > 0 en
+    // todo el tramo muestreado.
+    double step_x = h[0];
+    double step_y = h[3];
+    double step_w = h[6];
+    for (int y = 0; y < dst.height; ++y) {
+        unsigned char* row = dst.row(y);
+        double origin_x = h[1] * y + h[2];
+        double origin_y = h[4] * y + h[5];
+        double origin_w = h[7] * y + h[8];
+        
+        int begin, end;
+        clip_projective(origin_x, origin_y, origin_w, step_x, step_y, step_w,
+                        src_width, src_height, dst.width, begin, end);
+        
+        fill_run<C>(row, 0, begin, fill);
+        int x = begin + sample_span<Blend>(src, origin_x + begin * step_x, origin_y + begin * step_y,
+                                           origin_w + begin * step_w, step_x, step_y, step_w,
+                                           end - begin, row + begin * C);
+        for (; x < end; ++x) {
+            double w = 1.0 / (origin_w + x * step_w);
+            sample<C, Blend>(src, (origin_x + x * step_x) * w, (origin_y + x * step_y) * w, row + x * C);
+        }
+        fill_run<C>(row, end, dst.width, fill);
+    }
+}
+
+// Mismo reparto que render_warp; los planos usan el núcleo de un canal
+template <class Blend>
+void ImageProcessor::render_perspective(const ImageBuffer& src, ImageBuffer& dst,
+                                        const Homography& inverse, const unsigned char* fill) const {
+    if (src.planar) {
+        TiledImage tiled;
+        for (int c = 0; c < src.channels; ++c) {
+            if (tiled_rotation) {
+                tiled.from_view(src.plane(c));
+                perspective_kernel<1, Blend>(tiled, dst.plane(c), inverse, &fill[c]);
+            } else {
+                perspective_kernel<1, Blend>(src.plane(c), dst.plane(c), inverse, &fill[c]);
+            }
+        }
+    } else if (tiled_rotation) {
+        TiledImage tiled;
+        tiled.from_view(src.view());
+        ImageView out = dst.view();
+        switch (src.channels) {
+            case 1: perspective_kernel<1, Blend>(tiled, out, inverse, fill); break;
+            case 2: perspective_kernel<2, Blend>(tiled, out, inverse, fill); break;
+            case 3: perspective_kernel<3, Blend>(tiled, out, inverse, fill); break;
+            default: perspective_kernel<4, Blend>(tiled, out, inverse, fill); break;
+        }
+    } else {
+        ImageView in = src.view();
+        ImageView out = dst.view();
+        switch (src.channels) {
+            case 1: perspective_kernel<1, Blend>(in, out, inverse, fill); break;
+            case 2: perspective_kernel<2, Blend>(in, out, inverse, fill); break;
+            case 3: perspective_kernel<3, Blend>(in, out, inverse, fill); break;
+            default: perspective_kernel<4, Blend>(in, out, inverse, fill); break;
+        }
+    }
+}
+
+// Vecino más cercano: el píxel x copia el de origen que contiene
+// (origin_x + x * a, origin_y + x * c). Las coordenadas (desplazadas 0.5
+// para redondear) avanzan en punto fijo 32.32 con una suma entera por
+// píxel, sin error acumulado apreciable, y el índice es un desplazamiento.
+// El tramo se recorta como en warp_kernel pero con el criterio del vecino
+// (0 <= índice < ancho) y sus extremos se corrigen con la misma aritmética
+// entera. Devuelve en (fixed_x, fixed_y) las coordenadas del píxel begin.
+struct NearestStep {
+    int64_t x;
+    int64_t y;
+    
+    explicit NearestStep(const AffineTransform& inverse)
+        : x(std::llround(inverse.a * 4294967296.0)), y(std::llround(inverse.c * 4294967296.0)) {}
+};
+
+static void nearest_span(const AffineTransform& inverse, const NearestStep& step, int y,
+                         int src_width, int src_height, int dst_width,
+                         int& begin, int& end, int64_t& fixed_x, int64_t& fixed_y) {
+    const double ONE = 4294967296.0;
+    double origin_x = inverse.tx + y * inverse.b + 0.5;
+    double origin_y = inverse.ty + y * inverse.d + 0.5;
+    
+    begin = 0;
+    end = dst_width;
+    clip_axis(origin_x, inverse.a, src_width, begin, end);
+    clip_axis(origin_y, inverse.c, src_height, begin, end);
+    
+    // El punto fijo parte del primer píxel del recorte analítico, donde
+    // las coordenadas son pequeñas
+    int anchor = begin;
+    int64_t anchor_x = std::llround((origin_x + anchor * inverse.a) * ONE);
+    int64_t anchor_y = std::llround((origin_y + anchor * inverse.c) * ONE);
+    auto inside = [&](int x) {
+        int64_t px = anchor_x + (x - anchor) * step.x;
+        int64_t py = anchor_y + (x - anchor) * step.y;
+        return px >= 0 && (px >> 32) < src_width && py >= 0 && (py >> 32) < src_height;
+    };
+    if (begin < end) {
+        refine_span(inside, dst_width, begin, end);
+    }
+    fixed_x = anchor_x + (begin - anchor) * step.x;
+    fixed_y = anchor_y + (begin - anchor) * step.y;
+}
+
+// No hay mezcla ni vecinos: cada píxel es una copia de C bytes
+template <int C>
+void ImageProcessor::nearest_kernel(const ImageView& src, const ImageView& dst,
+                                    const AffineTransform& inverse, const unsigned char* fill) {
+    NearestStep step(inverse);
+    for (int y = 0; y < dst.height; ++y) {
+        unsigned char* row = dst.row(y);
+        int begin, end;
+        int64_t px, py;
+        nearest_span(inverse, step, y, src.width, src.height, dst.width, begin, end, px, py);
+        
+        fill_run<C>(row, 0, begin, fill);
+        for (int x = begin; x < end; ++x) {
+            std::memcpy(row + x * C, src.row(static_cast<int>(py >> 32)) + (px >> 32) * C, C);
+            px += step.x;
+            py += step.y;
+        }
+        fill_run<C>(row, end, dst.width, fill);
+    }
+}
+
+// Las teselas no aportan nada sin vecinos que agrupar: se lee siempre el
+// origen lineal
+void ImageProcessor::render_nearest(const ImageBuffer& src, ImageBuffer& dst,
+                                    const AffineTransform& inverse, const unsigned char* fill) {
+    if (src.planar) {
+        for (int c = 0; c < src.channels; ++c) {
+            nearest_kernel<1>(src.plane(c), dst.plane(c), inverse, &fill[c]);
+        }
+        return;
+    }
+    ImageView in = src.view();
+    ImageView out = dst.view();
+    switch (src.channels) {
+        case 1: nearest_kernel<1>(in, out, inverse, fill); break;
+        case 2: nearest_kernel<2>(in, out, inverse, fill); break;
+        case 3: nearest_kernel<3>(in, out, inverse, fill); break;
+        default: nearest_kernel<4>(in, out, inverse, fill); break;
+    }
+}
+
+// Tabla de remapeo de una homografía inversa con las mismas reglas que los
+// núcleos directos: los tramos salen de nearest_span, clip_span o
+// clip_projective y las posiciones se evalúan con las mismas expresiones,
+// de modo que la tabla reproduce el muestreo escalar.
+static std::shared_ptr<RemapTable> build_remap(const RemapKey& key) {
+    auto table = std::make_shared<RemapTable>();
+    table->key = key;
+    table->begin.resize(key.dst_height);
+    table->end.resize(key.dst_height);
+    table->offset.reserve(static_cast<size_t>(key.dst_width) * key.dst_height);
+    
+    const double* h = key.inverse;
+    const size_t stride = key.src_stride;
+    const int pixel_bytes = key.pixel_bytes;
+    bool affine = h[6] == 0 && h[7] == 0 && h[8] == 1;
+    AffineTransform inverse{h[0], h[1], h[2], h[3], h[4], h[5]};
+    NearestStep step(inverse);
+    
+    for (int y = 0; y < key.dst_height; ++y) {
+        int begin, end;
+        if (key.mode == RemapMode::Nearest) {
+            int64_t px, py;
+            nearest_span(inverse, step, y, key.src_width, key.src_height, key.dst_width,
+                         begin, end, px, py);
+            for (int x = begin; x < end; ++x) {
+                table->offset.push_back(static_cast<uint32_t>((py >> 32) * stride + (px >> 32) * pixel_bytes));
+                px += step.x;
+                py += step.y;
+            }
+        } else {
+            double origin_x = h[1] * y + h[2];
+            double origin_y = h[4] * y + h[5];
+            double origin_w = h[7] * y + h[8];
+            if (affine) {
+                clip_span(origin_x, origin_y, h[0], h[3], key.src_width, key.src_height,
+                          key.dst_width, begin, end);
+            } else {
+                clip_projective(origin_x, origin_y, origin_w, h[0], h[3], h[6],
+                                key.src_width, key.src_height, key.dst_width, begin, end);
+            }
+            for (int x = begin; x < end; ++x) {
+                double sx = origin_x + x * h[0];
+                double sy = origin_y + x * h[3];
+                if (!affine) {
+                    double w = 1.0 / (origin_w + x * h[6]);
+                    sx *= w;
+                    sy *= w;
+                }
+                int x0 = static_cast<int>(sx);
+                int y0 = static_cast<int>(sy);
+                table->offset.push_back(static_cast<uint32_t>(y0 * stride + x0 * pixel_bytes));
+                if (key.mode == RemapMode::BilinearFixed) {
+                    table->fixed_weight.push_back(static_cast<uint16_t>((sx - x0) * 256 + 0.5));
+                    table->fixed_weight.push_back(static_cast<uint16_t>((sy - y0) * 256 + 0.5));
+                } else {
+                    table->float_weight.push_back(static_cast<float>(sx - x0));
+                    table->float_weight.push_back(static_cast<float>(sy - y0));
+                }
+            }
+        }
+        table->begin[y] = begin;
+        table->end[y] = end;
+    }
+    table->offset.shrink_to_fit();
+    return table;
+}
+
+// Aplicación de una tabla: por cada píxel del tramo, un desplazamiento
+// leído de la tabla y (en bilineal) sus dos pesos. La mezcla entera es la
+// de FixedBlend; los pesos en float se mezclan en doble precisión con la
+// fórmula de DoubleBlend.
+template <int C>
+static void remap_kernel(const RemapTable& table, const ImageView& src, const ImageView& dst,
+                         const unsigned char* fill) {
+    const uint32_t* offset = table.offset.data();
+    const uint16_t* fixed_weight = table.fixed_weight.data();
+    const float* float_weight = table.float_weight.data();
+    const size_t stride = src.stride;
+    const int ONE = 256;
+    
+    for (int y = 0; y < dst.height; ++y) {
+        unsigned char* row = dst.row(y);
+        int begin = table.begin[y];
+        int end = table.end[y];
+        fill_run<C>(row, 0, begin, fill);
+        
+        unsigned char* out = row + begin * C;
+        switch (table.key.mode) {
+            case RemapMode::Nearest:
+                for (int x = begin; x < end; ++x, out += C) {
+                    std::memcpy(out, src.data + *offset++, C);
+                }
+                break;
+            case RemapMode::BilinearFixed:
+                for (int x = begin; x < end; ++x, out += C, fixed_weight += 2) {
+                    const unsigned char* p = src.data + *offset++;
+                    int fx = fixed_weight[0];
+                    int fy = fixed_weight[1];
+                    for (int c = 0; c < C; ++c) {
+                        int top = p[c] * (ONE - fx) + p[C + c] * fx;
+                        int bottom = p[stride + c] * (ONE - fx) + p[stride + C + c] * fx;
+                        out[c] = static_cast<unsigned char>((top * (ONE - fy) + bottom * fy) >> 16);
+                    }
+                }
+                break;
+            case RemapMode::BilinearFloat:
+                for (int x = begin; x < end; ++x, out += C, float_weight += 2) {
+                    const unsigned char* p = src.data + *offset++;
+                    double dx = float_weight[0];
+                    double dy = float_weight[1];
+                    for (int c = 0; c < C; ++c) {
+                        double value = p[c] * (1 - dx) * (1 - dy) +
+                                      p[C + c] * dx * (1 - dy) +
+                                      p[stride + c] * (1 - dx) * dy +
+                                      p[stride + C + c] * dx * dy;
+                        out[c] = static_cast<unsigned char>(static_cast<int>(value));
+                    }
+                }
+                break;
+        }
+        fill_run<C>(row, end, dst.width, fill);
+    }
+}
+
+bool ImageProcessor::render_remapped(const ImageBuffer& src, ImageBuffer& dst,
+                                     const Homography& inverse, RemapMode mode,
+                                     const unsigned char* fill) const {
+    RemapCache& cache = RemapCache::shared();
+    if (cache.get_max_cached_bytes() == 0 || src.plane_size() > UINT32_MAX) {
+        return false;
+    }
+    
+    // Con núcleos vectorizados las coordenadas bilineales salen casi gratis
+    // en registros y leer los desplazamientos y pesos de memoria es más
+    // lento que recalcularlos: solo el vecino más cercano (sin mezcla) o el
+    // muestreo escalar aprovechan la tabla
+    if (mode != RemapMode::Nearest && get_simd_level() != SimdLevel::Scalar) {
+        return false;
+    }
+    
+    // Los planos comparten geometría: una sola tabla sirve para todos
+    RemapKey key = {src.width, src.height, src.stride, src.pixel_bytes(),
+                    dst.width, dst.height, mode, {}};
+    std::copy(inverse.h, inverse.h + 9, key.inverse);
+    size_t weight_bytes = mode == RemapMode::Nearest ? 0
+                        : mode == RemapMode::BilinearFixed ? 2 * sizeof(uint16_t) : 2 * sizeof(float);
+    size_t table_bytes = static_cast<size_t>(dst.width) * dst.height * (sizeof(uint32_t) + weight_bytes) +
+                         2 * sizeof(int) * dst.height;
     
-    // Calcular centro de la imagen
-    double center_x = width / 2.0;
-    double center_y = height / 2.0;
+    bool build;
+    std::shared_ptr<const RemapTable> table = cache.lookup(key, table_bytes, build);
+    if (!table) {
+        if (!build) {
+            return false;
+        }
+        table = build_remap(key);
+        cache.insert(table);
+    }
+    
+    if (src.planar) {
+        for (int c = 0; c < src.channels; ++c) {
+            remap_kernel<1>(*table, src.plane(c), dst.plane(c), &fill[c]);
+        }
+        return true;
+    }
+    ImageView in = src.view();
+    ImageView out = dst.view();
+    switch (src.channels) {
+        case 1: remap_kernel<1>(*table, in, out, fill); break;
+        case 2: remap_kernel<2>(*table, in, out, fill); break;
+        case 3: remap_kernel<3>(*table, in, out, fill); break;
+        default: remap_kernel<4>(*table, in, out, fill); break;
+    }
+    return true;
+}
+
+// Transformación afín con el filtro y la aritmética elegidos; los lotes
+// repetidos se resuelven con la tabla de la caché de remapeo
+void ImageProcessor::render_affine(const ImageBuffer& src, ImageBuffer& dst,
+                                   const AffineTransform& inverse, const unsigned char* fill) const {
+    ImageBuffer source = bordered_source(src, fill);
+    AffineTransform shifted = AffineTransform::translation(src.apron, src.apron) * inverse;
     
+    bool nearest = interpolation == Interpolation::Nearest;
+    RemapMode mode = nearest ? RemapMode::Nearest
+                   : fixed_point ? RemapMode::BilinearFixed : RemapMode::BilinearFloat;
+    if (render_remapped(source, dst, Homography::from_affine(shifted), mode, fill)) {
+        return;
+    }
+    if (nearest) {
+        render_nearest(source, dst, shifted, fill);
+    } else if (fixed_point) {
+        render_warp<FixedBlend>(source, dst, shifted, fill);
+    } else {
+        render_warp<DoubleBlend>(source, dst, shifted, fill);
+    }
+}
+
+// Rotación alrededor del centro con el mismo tamaño: el origen de cada
+// píxel se obtiene con el giro opuesto
+template <class Blend>
+void ImageProcessor::render_rotation(const ImageBuffer& src, ImageBuffer& dst, double angle,
+                                     const unsigned char* fill) const {
+    render_warp<Blend>(src, dst, AffineTransform::rotation(-angle, src.width / 2.0, src.height / 2.0),
+                       fill);
+}
+
+ImageBuffer ImageProcessor::rotate_internal(double angle, const unsigned char* fill) const {
     // Crear una nueva imagen rotada (mismo tamaño)
-    Pixel** rotated = allocate_pixels(width, height, using_buddy);
+    ImageBuffer rotated = allocate_pixels(width, height, channels);
+    
+    bool shear = rotation_engine == RotationEngine::ThreeShear || interpolation != Interpolation::Bilinear;
+    if (shear && interpolation != Interpolation::Nearest) {
+        render_shear_rotation(pixels, rotated, angle, fill);
+    } else {
+        render_affine(pixels, rotated, AffineTransform::rotation(-angle, width / 2.0, height / 2.0),
+                      fill);
+    }
+    return rotated;
+}
+
+// Rotación por tres cizallas (Paeth): la matriz de rotación inversa
+// [[cos, sin], [-sin, cos]] se factoriza como Sx(a) * Sy(b) * Sx(a), con
+// Sx(a) = [[1, a], [0, 1]], Sy(b) = [[1, 0], [b, 1]], a = tan(φ/2), b = -sin(φ).
+// Cada factor desplaza filas (Sx) o columnas (Sy) enteras una cantidad
+// constante, así que cada pasada es una interpolación lineal 1D con un único
+// peso por fila o columna y recorre la memoria de forma secuencial.
+// Coordenadas relativas: u en el destino, w2 = Sx(a) u en la segunda pasada,
+// w1 = Sy(b) w2 en la primera y Sx(a) w1 en el origen.
+struct ImageProcessor::ShearGeometry {
+    double a;              // tan(φ/2)
+    double b;              // -sin(φ)
+    double center_x;       // Centro del origen
+    double center_y;
+    double dst_center_x;   // Centro del destino
+    double dst_center_y;
+    double origin_x;       // w.x de la columna 0 de ambas pasadas intermedias
+    double origin_y;       // w1.y de la fila 0 de la primera pasada
+    int width;             // Ancho de las pasadas intermedias
+    int first_row;         // Fila del origen que da la fila 0 de la primera pasada
+    int rows;              // Filas de la primera pasada (filas útiles del origen)
+};
+
+// Índice entero y peso 8.8 del vecino siguiente para una posición fraccionaria
+static void split_shift(double shift, int& index, int& weight) {
+    double base = std::floor(shift);
+    index = static_cast<int>(base);
+    weight = static_cast<int>((shift - base) * 256 + 0.5);
+    if (weight == 256) {
+        index++;
+        weight = 0;
+    }
+}
+
+// Las cizallas filtran con pesos enteros de SHEAR_BITS bits: los 8.8 de la
+// bilineal se amplían sin pérdida y dan exactamente el mismo resultado
+static const int SHEAR_BITS = 12;
+
+// Muestras de un desplazamiento fraccionario: valor = Σ weight[k] * in[index + k]
+template <int TAPS>
+struct ShearTaps {
+    int index;
+    int weight[TAPS];
+};
+
+template <int TAPS>
+static ShearTaps<TAPS> shear_taps(double shift, Interpolation filter) {
+    ShearTaps<TAPS> taps;
+    if (TAPS == 2) {
+        int weight;
+        split_shift(shift, taps.index, weight);
+        taps.weight[0] = (256 - weight) << (SHEAR_BITS - 8);
+        taps.weight[1] = weight << (SHEAR_BITS - 8);
+        return taps;
+    }
+    
+    // Pesos normalizados; el error de redondeo va a la muestra más cercana
+    double base = std::floor(shift);
+    double fraction = shift - base;
+    taps.index = static_cast<int>(base) - (TAPS / 2 - 1);
+    double w[TAPS];
+    double total = 0;
+    for (int k = 0; k < TAPS; ++k) {
+        w[k] = interpolation_weight(filter, fraction - (k - (TAPS / 2 - 1)));
+        total += w[k];
+    }
+    int sum = 0;
+    for (int k = 0; k < TAPS; ++k) {
+        taps.weight[k] = static_cast<int>(std::lround(w[k] / total * (1 << SHEAR_BITS)));
+        sum += taps.weight[k];
+    }
+    taps.weight[TAPS / 2 - 1 + (fraction >= 0.5 ? 1 : 0)] += (1 << SHEAR_BITS) - sum;
+    return taps;
+}
+
+// Redondeo y saturación de una suma ponderada (los lóbulos negativos de los
+// filtros de orden superior pueden salirse de 0-255)
+static inline unsigned char shear_round(int sum) {
+    int value = (sum + (1 << (SHEAR_BITS - 1))) >> SHEAR_BITS;
+    return static_cast<unsigned char>(value < 0 ? 0 : (value > 255 ? 255 : value));
+}
+
+// p[k]: píxel de la muestra k (del origen o el color de fondo)
+template <int C, int TAPS>
+static void filter_pixel(const unsigned char* const* p, const int* weight, unsigned char* out) {
+    for (int c = 0; c < C; ++c) {
+        int sum = 0;
+        for (int k = 0; k < TAPS; ++k) {
+            sum += p[k][c] * weight[k];
+        }
+        out[c] = shear_round(sum);
+    }
+}
+
+// Tramos interiores de las cizallas: out[j] = Σ weight[k] * in[j + k * step].
+// El mismo bucle se compila para el conjunto base y para AVX2 (productos de
+// enteros de 32 bits en vector) y se elige según el nivel SIMD activo.
+template <int TAPS>
+static inline __attribute__((always_inline)) void weighted_run(const unsigned char* in, size_t step,
+                                                               const int* weight, unsigned char* out,
+                                                               int count) {
+    if (TAPS == 2) {
+        // Bilineal: pesos 8.8 no negativos, la suma cabe en 16 bits y no
+        // hace falta saturar
+        int w0 = weight[0] >> (SHEAR_BITS - 8);
+        int w1 = weight[1] >> (SHEAR_BITS - 8);
+        for (int j = 0; j < count; ++j) {
+            out[j] = static_cast<unsigned char>((in[j] * w0 + in[j + step] * w1 + 128) >> 8);
+        }
+        return;
+    }
+    for (int j = 0; j < count; ++j) {
+        int sum = 0;
+        for (int k = 0; k < TAPS; ++k) {
+            sum += in[j + k * step] * weight[k];
+        }
+        out[j] = shear_round(sum);
+    }
+}
+
+template <int TAPS>
+__attribute__((target("avx2")))
+static void weighted_run_avx2(const unsigned char* in, size_t step, const int* weight,
+                              unsigned char* out, int count) {
+    weighted_run<TAPS>(in, step, weight, out, count);
+}
+
+// Variante con muestras y pesos propios por byte (cizalla vertical): la
+// muestra k del byte j está en in[offset[j] + k * step] y pesa weight[k * count + j].
+// Los accesos son dispersos; con AVX2 el compilador usaría recogidas, que
+// aquí resultan más lentas que las cargas escalares.
+template <int TAPS>
+static void weighted_gather(const unsigned char* in, const ptrdiff_t* offset, size_t step,
+                            const int* weight, unsigned char* out, int count) {
+    for (int j = 0; j < count; ++j) {
+        const unsigned char* p = in + offset[j];
+        int sum = 0;
+        for (int k = 0; k < TAPS; ++k) {
+            sum += p[k * step] * weight[k * count + j];
+        }
+        out[j] = shear_round(sum);
+    }
+}
+
+// out[i] = in en la posición i + shift. Fuera de [0, in_count) las muestras
+// son el color de fondo, de modo que el borde queda suavizado en vez de recortado.
+template <int C, int TAPS>
+static void shear_line(const unsigned char* in, int in_count, unsigned char* out, int out_count,
+                       double shift, Interpolation filter, const unsigned char* fill) {
+    ShearTaps<TAPS> taps = shear_taps<TAPS>(shift, filter);
+    int offset = taps.index;
+    int weight[TAPS];
+    std::copy(taps.weight, taps.weight + TAPS, weight);
     
-    // Rellenar con el color de fondo
-    Pixel fill_pixel{fill_r, fill_g, fill_b, fill_a};
-    for (int y = 0; y < height; ++y) {
-        for (int x = 0; x < width; ++x) {
-            rotated[y][x] = fill_pixel;
+    auto edge = [&](int i) {
+        const unsigned char* p[TAPS];
+        for (int k = 0; k < TAPS; ++k) {
+            int x = i + offset + k;
+            p[k] = (x >= 0 && x < in_count) ? in + x * C : fill;
         }
+        filter_pixel<C, TAPS>(p, weight, out + i * C);
+    };
+    
+    // Tramo interior: todas las muestras existen. Fuera de él solo TAPS - 1
+    // píxeles a cada lado mezclan con el fondo; el resto es fondo puro.
+    int begin = std::min(out_count, std::max(0, -offset));
+    int end = std::max(begin, std::min(out_count, in_count - (TAPS - 1) - offset));
+    int fill_end = std::max(0, begin - (TAPS - 1));
+    int fill_begin = std::min(out_count, std::max(end + TAPS - 1, in_count - offset));
+    
+    fill_run<C>(out, 0, fill_end, fill);
+    for (int i = fill_end; i < begin; ++i) edge(i);
+    
+    // En el interior la muestra k está siempre k * C bytes más allá: un
+    // único bucle sobre bytes, sin distinguir canales, que se vectoriza
+    const unsigned char* p = in + (begin + offset) * C;
+    unsigned char* q = out + begin * C;
+    int bytes = (end - begin) * C;
+    if (get_simd_level() >= SimdLevel::AVX2) {
+        weighted_run_avx2<TAPS>(p, C, weight, q, bytes);
+    } else {
+        weighted_run<TAPS>(p, C, weight, q, bytes);
     }
     
-    // Aplicar rotación
-    for (int y = 0; y < height; ++y) {
-        for (int x = 0; x < width; ++x) {
-            // Convertir a coordenadas relativas al centro
-            double rel_x = x - center_x;
-            double rel_y = y - center_y;
-            
-            // Aplicar rotación inversa
-            double src_x = center_x + rel_x * cos(radians) + (rel_y * sin(radians));
-            double src_y = center_y + -rel_x * sin(radians) + (rel_y * cos(radians));
-            
-            // Si el punto de origen está dentro de la imagen original, interpolar
-            if (src_x >= 0 && src_x < width - 1 && src_y >= 0 && src_y < height - 1) {
-                rotated[y][x] = interpolate(src_x, src_y);
+    for (int i = end; i < fill_begin; ++i) edge(i);
+    fill_run<C>(out, fill_begin, out_count, fill);
+}
+
+// Columnas que se desplazan juntas en la cizalla vertical: las filas de
+// origen que toca una franja avanzan a la par, así que caben en caché
+static const int SHEAR_STRIP = 64;
+
+// dst(x, y) = Σ taps[x].weight[k] * src en la fila y + taps[x].index + k
+template <int C, int TAPS>
+static void shear_columns(const ImageView& src, int rows, const ImageView& dst,
+                          const ShearTaps<TAPS>* taps, const unsigned char* fill) {
+    ptrdiff_t offset[SHEAR_STRIP * C];
+    int weight[TAPS * SHEAR_STRIP * C];
+    
+    for (int x_begin = 0; x_begin < dst.width; x_begin += SHEAR_STRIP) {
+        int x_end = std::min(dst.width, x_begin + SHEAR_STRIP);
+        
+        // Desplazamiento de cada byte de la franja respecto al inicio de la
+        // fila de destino y sus pesos, comunes a todas las filas interiores
+        int bytes = (x_end - x_begin) * C;
+        for (int x = x_begin; x < x_end; ++x) {
+            for (int c = 0; c < C; ++c) {
+                int j = (x - x_begin) * C + c;
+                offset[j] = static_cast<ptrdiff_t>(taps[x].index) * src.stride + j;
+                for (int k = 0; k < TAPS; ++k) {
+                    weight[k * bytes + j] = taps[x].weight[k];
+                }
+            }
+        }
+        
+        // Filas de destino en las que toda la franja tiene todas sus muestras
+        int min_offset = taps[x_begin].index;
+        int max_offset = taps[x_begin].index;
+        for (int x = x_begin; x < x_end; ++x) {
+            min_offset = std::min(min_offset, taps[x].index);
+            max_offset = std::max(max_offset, taps[x].index);
+        }
+        int inner_begin = std::min(dst.height, std::max(0, -min_offset));
+        int inner_end = std::max(inner_begin, std::min(dst.height, rows - (TAPS - 1) - max_offset));
+        
+        // Filas en las que ningún píxel de la franja alcanza el origen
+        int outer_begin = std::max(0, -max_offset - (TAPS - 1));
+        int outer_end = std::max(0, rows - min_offset);
+        
+        for (int y = 0; y < dst.height; ++y) {
+            unsigned char* out = dst.row(y);
+            if (y < outer_begin || y >= outer_end) {
+                fill_run<C>(out, x_begin, x_end, fill);
+                continue;
+            }
+            if (y >= inner_begin && y < inner_end) {
+                const unsigned char* in = src.data + static_cast<size_t>(y) * src.stride + x_begin * C;
+                weighted_gather<TAPS>(in, offset, src.stride, weight, out + x_begin * C, bytes);
+                continue;
+            }
+            const unsigned char* p[TAPS];
+            for (int x = x_begin; x < x_end; ++x) {
+                for (int k = 0; k < TAPS; ++k) {
+                    int r = y + taps[x].index + k;
+                    p[k] = (r >= 0 && r < rows) ? src.row(r) + x * C : fill;
+                }
+                filter_pixel<C, TAPS>(p, taps[x].weight, out + x * C);
             }
         }
     }
+}
+
+template <int C, int TAPS>
+void ImageProcessor::shear_kernel(const ImageView& src, const ImageView& pass1, const ImageView& pass2,
+                                  const ImageView& dst, const ShearGeometry& g,
+                                  Interpolation filter, const unsigned char* fill) {
+    // 1) Cizalla horizontal: la fila j de pass1 es la fila first_row + j del
+    //    origen desplazada a * w1.y
+    for (int j = 0; j < g.rows; ++j) {
+        double shift = g.center_x + g.origin_x + g.a * (j + g.origin_y);
+        shear_line<C, TAPS>(src.row(g.first_row + j), src.width, pass1.row(j), g.width, shift,
+                            filter, fill);
+    }
     
-    // Liberar la imagen original y reemplazar con la rotada
-    free_pixels(pixels, height, using_buddy);
-    pixels = rotated;
+    // 2) Cizalla vertical: la columna i se desplaza b * w2.x filas
+    std::vector<ShearTaps<TAPS>> taps(g.width);
+    for (int i = 0; i < g.width; ++i) {
+        double shift = g.b * (i + g.origin_x) - g.dst_center_y - g.origin_y;
+        taps[i] = shear_taps<TAPS>(shift, filter);
+    }
+    shear_columns<C, TAPS>(pass1, g.rows, pass2, taps.data(), fill);
+    
+    // 3) Cizalla horizontal final sobre las filas del destino
+    for (int y = 0; y < dst.height; ++y) {
+        double shift = g.a * (y - g.dst_center_y) - g.dst_center_x - g.origin_x;
+        shear_line<C, TAPS>(pass2.row(y), g.width, dst.row(y), dst.width, shift, filter, fill);
+    }
+}
+
+template <int TAPS>
+void ImageProcessor::shear_pixels(int pixel_bytes, const ImageView& src, const ImageView& pass1,
+                                  const ImageView& pass2, const ImageView& dst,
+                                  const ShearGeometry& g, Interpolation filter,
+                                  const unsigned char* fill) {
+    switch (pixel_bytes) {
+        case 1: shear_kernel<1, TAPS>(src, pass1, pass2, dst, g, filter, fill); break;
+        case 2: shear_kernel<2, TAPS>(src, pass1, pass2, dst, g, filter, fill); break;
+        case 3: shear_kernel<3, TAPS>(src, pass1, pass2, dst, g, filter, fill); break;
+        default: shear_kernel<4, TAPS>(src, pass1, pass2, dst, g, filter, fill); break;
+    }
+}
+
+void ImageProcessor::render_shear_rotation(const ImageBuffer& src, ImageBuffer& dst, double angle,
+                                           const unsigned char* fill) const {
+    // Las cizallas crecen con tan(φ/2) (infinitas a 180 grados): se aplica
+    // primero un cuarto de vuelta exacto y se cizalla solo el resto, |φ| <= 45
+    int quarter = static_cast<int>(std::floor(angle / 90.0 + 0.5));
+    double rest = angle - quarter * 90.0;
+    quarter = ((quarter % 4) + 4) % 4;
+    
+    int planes = src.planar ? src.channels : 1;
+    int pixel_bytes = src.pixel_bytes();
+    double center_x = src.width / 2.0;
+    double center_y = src.height / 2.0;
+    
+    ImageBuffer turned;
+    const ImageBuffer* source = &src;
+    if (quarter != 0) {
+        bool swapped = quarter != 2;
+        turned = allocate_pixels(swapped ? src.height : src.width, swapped ? src.width : src.height,
+                                 src.channels);
+        for (int p = 0; p < planes; ++p) {
+            ImageView in = src.planar ? src.plane(p) : src.view();
+            ImageView out = turned.planar ? turned.plane(p) : turned.view();
+            if (quarter == 2) {
+                // Copia y media vuelta en el sitio
+                for (int y = 0; y < in.height; ++y) {
+                    std::memcpy(out.row(y), in.row(y), static_cast<size_t>(in.width) * pixel_bytes);
+                }
+                switch (pixel_bytes) {
+                    case 1: rotate_half_turn<1>(out); break;
+                    case 2: rotate_half_turn<2>(out); break;
+                    case 3: rotate_half_turn<3>(out); break;
+                    default: rotate_half_turn<4>(out); break;
+                }
+            } else {
+                switch (pixel_bytes) {
+                    case 1: rotate_quarter<1>(in, out, quarter, 0, out.width, 0, out.height); break;
+                    case 2: rotate_quarter<2>(in, out, quarter, 0, out.width, 0, out.height); break;
+                    case 3: rotate_quarter<3>(in, out, quarter, 0, out.width, 0, out.height); break;
+                    default: rotate_quarter<4>(in, out, quarter, 0, out.width, 0, out.height); break;
+                }
+            }
+        }
+        
+        // Centro del origen en coordenadas de la copia girada
+        double turned_x, turned_y;
+        if (quarter == 1) {
+            turned_x = src.height - 1 - center_y;
+            turned_y = center_x;
+        } else if (quarter == 2) {
+            turned_x = src.width - 1 - center_x;
+            turned_y = src.height - 1 - center_y;
+        } else {
+            turned_x = center_y;
+            turned_y = src.width - 1 - center_x;
+        }
+        center_x = turned_x;
+        center_y = turned_y;
+        source = &turned;
+    }
+    
+    ShearGeometry g;
+    double radians = rest * M_PI / 180.0;
+    g.a = std::tan(radians / 2);
+    g.b = -std::sin(radians);
+    g.center_x = center_x;
+    g.center_y = center_y;
+    g.dst_center_x = dst.width / 2.0;
+    g.dst_center_y = dst.height / 2.0;
+    
+    // Columnas intermedias: w2.x = u.x + a * u.y sobre todo el destino
+    double top = g.a * -g.dst_center_y;
+    double bottom = g.a * (dst.height - 1 - g.dst_center_y);
+    double min_x = -g.dst_center_x + std::min(top, bottom);
+    double max_x = dst.width - 1 - g.dst_center_x + std::max(top, bottom);
+    g.origin_x = std::floor(min_x);
+    g.width = static_cast<int>(std::floor(max_x) - g.origin_x) + 2;
+    
+    // Filas del origen que alcanza la cizalla vertical: w1.y = w2.y + b * w2.x
+    double left = g.b * g.origin_x;
+    double right = g.b * (g.origin_x + g.width - 1);
+    double min_y = -g.dst_center_y + std::min(left, right);
+    double max_y = dst.height - 1 - g.dst_center_y + std::max(left, right);
+    int first = std::max(0, static_cast<int>(std::floor(center_y + min_y)));
+    int last = std::min(source->height - 1, static_cast<int>(std::floor(center_y + max_y)) + 1);
+    g.first_row = first;
+    g.rows = std::max(0, last - first + 1);
+    g.origin_y = first - center_y;
+    
+    ImageBuffer pass1 = allocate_pixels(g.width, std::max(1, g.rows), src.channels);
+    ImageBuffer pass2 = allocate_pixels(g.width, dst.height, src.channels);
+    
+    for (int p = 0; p < planes; ++p) {
+        ImageView in = source->planar ? source->plane(p) : source->view();
+        ImageView first_pass = pass1.planar ? pass1.plane(p) : pass1.view();
+        ImageView second_pass = pass2.planar ? pass2.plane(p) : pass2.view();
+        ImageView out = dst.planar ? dst.plane(p) : dst.view();
+        const unsigned char* plane_fill = src.planar ? &fill[p] : fill;
+        switch (interpolation_taps(interpolation)) {
+            case 2:
+                shear_pixels<2>(pixel_bytes, in, first_pass, second_pass, out, g, interpolation, plane_fill);
+                break;
+            case 4:
+                shear_pixels<4>(pixel_bytes, in, first_pass, second_pass, out, g, interpolation, plane_fill);
+                break;
+            default:
+                shear_pixels<6>(pixel_bytes, in, first_pass, second_pass, out, g, interpolation, plane_fill);
+                break;
+        }
+    }
+    
+    free_pixels(pass1);
+    free_pixels(pass2);
+    free_pixels(turned);
+}
+
+// Los núcleos planares procesan la fila de salida en bloques de PLANE_BLOCK
+// píxeles: primero calculan coordenadas y pesos del bloque, luego recogen los
+// cuatro vecinos de cada píxel y por último mezclan. Los bucles de cálculo y
+// mezcla no tienen dependencias entre píxeles y el compilador los vectoriza.
+static const int PLANE_BLOCK = 16;
+
+// Mezcla bilineal de un bloque completo de un plano. Cada instancia recorre
+// el bloque sin ramas; la entera trabaja con pesos 8.8 igual que FixedBlend.
+template <bool FIXED>
+static void blend_plane_block(const int* p00, const int* p10, const int* p01, const int* p11,
+                              const float* src_x, const float* src_y, unsigned char* out) {
+    if (FIXED) {
+        const int one = 1 << 8;
+        for (int i = 0; i < PLANE_BLOCK; ++i) {
+            int fx = static_cast<int>(src_x[i] * one + 0.5f);
+            int fy = static_cast<int>(src_y[i] * one + 0.5f);
+            int top = p00[i] * (one - fx) + p10[i] * fx;
+            int bottom = p01[i] * (one - fx) + p11[i] * fx;
+            out[i] = static_cast<unsigned char>((top * (one - fy) + bottom * fy) >> 16);
+        }
+    } else {
+        for (int i = 0; i < PLANE_BLOCK; ++i) {
+            float dx = src_x[i];
+            float dy = src_y[i];
+            float value = p00[i] * (1 - dx) * (1 - dy) +
+                          p10[i] * dx * (1 - dy) +
+                          p01[i] * (1 - dx) * dy +
+                          p11[i] * dx * dy;
+            out[i] = static_cast<unsigned char>(static_cast<int>(value));
+        }
+    }
+}
+
+template <class Blend>
+void ImageProcessor::warp_plane(const ImageView& src, const ImageView& dst,
+                                const AffineTransform& inverse, unsigned char fill,
+                                int tile, bool prefetch, bool stream) {
+    double dx = inverse.a;
+    double dy = inverse.c;
+    int last_x0 = src.width - 2;
+    int last_y0 = src.height - 2;
+    
+    // Desplazamiento de cada píxel del bloque respecto al primero
+    float step_x[PLANE_BLOCK], step_y[PLANE_BLOCK];
+    for (int i = 0; i < PLANE_BLOCK; ++i) {
+        step_x[i] = static_cast<float>(i * dx);
+        step_y[i] = static_cast<float>(i * dy);
+    }
+    
+    float src_x[PLANE_BLOCK], src_y[PLANE_BLOCK];
+    int p00[PLANE_BLOCK], p01[PLANE_BLOCK], p10[PLANE_BLOCK], p11[PLANE_BLOCK];
+    size_t offset[PLANE_BLOCK];
+    
+    std::vector<int> spans(2 * static_cast<size_t>(dst.height));
+    for (int y = 0; y < dst.height; ++y) {
+        double origin_x = inverse.tx + y * inverse.b;
+        double origin_y = inverse.ty + y * inverse.d;
+        clip_span(origin_x, origin_y, dx, dy, src.width, src.height, dst.width,
+                  spans[2 * y], spans[2 * y + 1]);
+    }
+    
+    int gap = prefetch_gap(tile);
+    OutputRows rows(dst, stream);
+    auto segment = [&](int y, int x_begin, int x_end, int next_end) {
+        unsigned char* row = rows.row(y);
+        double origin_x = inverse.tx + y * inverse.b;
+        double origin_y = inverse.ty + y * inverse.d;
+        int row_begin = spans[2 * y];
+        int row_end = spans[2 * y + 1];
+        
+        int left = std::min(std::max(row_begin, x_begin), x_end);
+        std::memset(row + x_begin, fill, left - x_begin);
+        int begin, end;
+        segment_span(row_begin, row_end, x_begin, x_end, dst.width, begin, end);
+        
+        BilinearSpan span = {src, origin_x + begin * dx, origin_y + begin * dy,
+                             dx, dy, end - begin, row + begin};
+        int x = begin + bilinear_span(span, Blend::FIXED);
+        
+        // Sin núcleo vectorizado, interior en bloques completos: el origen de
+        // cada bloque se calcula en doble precisión y cada píxel suma su
+        // desplazamiento en float. El recorte garantiza que todos los puntos
+        // son interiores; el min() solo absorbe el redondeo a float en el
+        // último píxel válido.
+        for (; x + PLANE_BLOCK <= end; x += PLANE_BLOCK) {
+            float base_x = static_cast<float>(origin_x + x * dx);
+            float base_y = static_cast<float>(origin_y + x * dy);
+            
+            for (int i = 0; i < PLANE_BLOCK; ++i) {
+                float sx = base_x + step_x[i];
+                float sy = base_y + step_y[i];
+                int x0 = std::min(static_cast<int>(sx), last_x0);
+                int y0 = std::min(static_cast<int>(sy), last_y0);
+                src_x[i] = sx - x0;
+                src_y[i] = sy - y0;
+                offset[i] = y0 * src.stride + x0;
+            }
+            
+            // Recoger los cuatro vecinos (accesos dispersos, escalar)
+            for (int i = 0; i < PLANE_BLOCK; ++i) {
+                const unsigned char* p = src.data + offset[i];
+                p00[i] = p[0];
+                p10[i] = p[1];
+                p01[i] = p[src.stride];
+                p11[i] = p[src.stride + 1];
+            }
+            
+            // Mezcla bilineal directamente sobre la fila de salida
+            blend_plane_block<Blend::FIXED>(p00, p10, p01, p11, src_x, src_y, row + x);
+        }
+        
+        // Resto del tramo (menos de un bloque)
+        for (; x < end; ++x) {
+            double sx = origin_x + x * dx;
+            double sy = origin_y + x * dy;
+            sample<1, Blend>(src, sx, sy, row + x);
+        }
+        
+        int right = std::max(std::min(row_end, x_end), x_begin);
+        std::memset(row + right, fill, x_end - right);
+        
+        if (rows.streaming()) {
+            rows.commit(y, x_begin, left);
+            rows.commit(y, begin, end);
+            rows.commit(y, right, x_end);
+        }
+        
+        if (prefetch) {
+            int next_begin;
+            segment_span(row_begin, row_end, x_end, next_end, dst.width, next_begin, end);
+            for (int p = next_begin; p < end; p += gap) {
+                prefetch_source(src, origin_x + p * dx, origin_y + p * dy);
+            }
+        }
+    };
+    traverse_output(dst.width, dst.height, tile, segment);
 }
 
 void ImageProcessor::scale(double factor) {
@@ -266,7 +1801,7 @@ void ImageProcessor::scale(double factor) {
     int old_width = width;
     int old_height = height;
     
-    scale_internal(factor);
+    *this = scaled(factor);
     
     auto end = std::chrono::high_resolution_clock::now();
     auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
@@ -280,33 +1815,287 @@ void ImageProcessor::scale(double factor) {
     std::cout << "=============================" << std::endl;
 }
 
-void ImageProcessor::scale_internal(double factor) {
+void ImageProcessor::affine(const AffineTransform& transform, int out_width, int out_height,
+                            unsigned char fill_r, unsigned char fill_g,
+                            unsigned char fill_b, unsigned char fill_a) {
+    if (!pixels) return;
+    
+    AffineTransform inverse;
+    if (!transform.invert(inverse)) {
+        std::cerr << "La transformación afín no es invertible" << std::endl;
+        return;
+    }
+    if (out_width <= 0) out_width = width;
+    if (out_height <= 0) out_height = height;
+    
+    auto start = std::chrono::high_resolution_clock::now();
+    
+    ImageBuffer warped = allocate_pixels(out_width, out_height, channels);
+    unsigned char fill[4];
+    fill_for_channels(Pixel{fill_r, fill_g, fill_b, fill_a}, channels, fill);
+    
+    render_affine(pixels, warped, inverse, fill);
+    
+    width = out_width;
+    height = out_height;
+    free_pixels(pixels);
+    pixels = std::move(warped);
+    
+    auto end = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
+    std::cout << "Transformación afín completada en " << duration.count() << " ms" << std::endl;
+}
+
+void ImageProcessor::perspective(const Homography& transform, int out_width, int out_height,
+                                 unsigned char fill_r, unsigned char fill_g,
+                                 unsigned char fill_b, unsigned char fill_a) {
+    if (!pixels) return;
+    
+    Homography inverse;
+    if (!transform.invert(inverse)) {
+        std::cerr << "La homografía no es invertible" << std::endl;
+        return;
+    }
+    if (out_width <= 0) out_width = width;
+    if (out_height <= 0) out_height = height;
+    
+    auto start = std::chrono::high_resolution_clock::now();
+    
+    ImageBuffer warped = allocate_pixels(out_width, out_height, channels);
+    unsigned char fill[4];
+    fill_for_channels(Pixel{fill_r, fill_g, fill_b, fill_a}, channels, fill);
+    
+    ImageBuffer source = bordered_source(pixels, fill);
+    Homography shifted =
+        Homography::from_affine(AffineTransform::translation(pixels.apron, pixels.apron)) * inverse;
+    
+    RemapMode mode = fixed_point ? RemapMode::BilinearFixed : RemapMode::BilinearFloat;
+    if (!render_remapped(source, warped, shifted, mode, fill)) {
+        if (fixed_point) {
+            render_perspective<FixedBlend>(source, warped, shifted, fill);
+        } else {
+            render_perspective<DoubleBlend>(source, warped, shifted, fill);
+        }
+    }
+    
+    width = out_width;
+    height = out_height;
+    free_pixels(pixels);
+    pixels = std::move(warped);
+    
+    auto end = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
+    std::cout << "Corrección de perspectiva completada en " << duration.count() << " ms" << std::endl;
+}
+
+template <class Blend>
+void ImageProcessor::render_scale(const ImageBuffer& src, ImageBuffer& dst, double factor) const {
+    // Las tablas de índices y pesos se calculan una vez y sirven para todos
+    // los planos
+    Resampler resampler(src.width, src.height, dst.width, dst.height, factor, Blend::FIXED,
+                        interpolation);
+    if (src.planar) {
+        for (int c = 0; c < src.channels; ++c) {
+            resampler.run(src.plane(c), dst.plane(c));
+        }
+    } else {
+        resampler.run(src.view(), dst.view());
+    }
+}
+
+ImageProcessor ImageProcessor::scaled(double factor) const {
+    ImageProcessor result = empty_like();
+    if (!pixels || factor <= 0) return result;
+    
+    result.pixels = scale_internal(factor);
+    result.width = result.pixels.width;
+    result.height = result.pixels.height;
+    result.channels = channels;
+    return result;
+}
+
+ImageBuffer ImageProcessor::scale_internal(double factor) const {
     int new_width = static_cast<int>(width * factor);
     int new_height = static_cast<int>(height * factor);
     
     // Crear nueva imagen escalada
-    Pixel** scaled = allocate_pixels(new_width, new_height, using_buddy);
+    ImageBuffer scaled = allocate_pixels(new_width, new_height, channels);
     
     // Escalar la imagen
-    for (int y = 0; y < new_height; ++y) {
-        for (int x = 0; x < new_width; ++x) {
-            // Mapear coordenadas de la nueva imagen a la original
-            double src_x = (x + 0.5) / factor - 0.5;
-            double src_y = (y + 0.5) / factor - 0.5;
-            
-            // Interpolar el valor del píxel
-            scaled[y][x] = interpolate(src_x, src_y);
+    if (fixed_point) {
+        render_scale<FixedBlend>(pixels, scaled, factor);
+    } else {
+        render_scale<DoubleBlend>(pixels, scaled, factor);
+    }
+    return scaled;
+}
+
+// Máxima diferencia absoluta entre dos buffers de las mismas dimensiones
+// (y opcionalmente la media)
+static int max_difference(const ImageBuffer& a, const ImageBuffer& b, double* mean = nullptr) {
+    int planes = a.planar ? a.channels : 1;
+    size_t row_bytes = static_cast<size_t>(a.width) * a.pixel_bytes();
+    int max_diff = 0;
+    double total = 0;
+    for (int p = 0; p < planes; ++p) {
+        ImageView va = a.planar ? a.plane(p) : a.view();
+        ImageView vb = b.planar ? b.plane(p) : b.view();
+        for (int y = 0; y < a.height; ++y) {
+            const unsigned char* ra = va.row(y);
+            const unsigned char* rb = vb.row(y);
+            for (size_t i = 0; i < row_bytes; ++i) {
+                int diff = std::abs(ra[i] - rb[i]);
+                max_diff = std::max(max_diff, diff);
+                total += diff;
+            }
         }
     }
+    if (mean) {
+        *mean = total / (static_cast<double>(row_bytes) * a.height * planes);
+    }
+    return max_diff;
+}
+
+bool ImageProcessor::verify_fixed_point() const {
+    if (!pixels) return false;
     
-    // Actualizar dimensiones
-    int old_height = height;
-    width = new_width;
-    height = new_height;
+    // Ángulo y factores sin simetrías, para ejercitar pesos arbitrarios
+    const double angle = 33.3;
+    const double factors[] = {0.73, 1.37};
+    unsigned char fill[4] = {0, 0, 0, 255};
+    
+    ImageBuffer reference = allocate_pixels(width, height, channels);
+    ImageBuffer fixed = allocate_pixels(width, height, channels);
+    render_rotation<DoubleBlend>(pixels, reference, angle, fill);
+    render_rotation<FixedBlend>(pixels, fixed, angle, fill);
+    int rotate_error = max_difference(reference, fixed);
+    free_pixels(reference);
+    free_pixels(fixed);
+    
+    int scale_error = 0;
+    for (double factor : factors) {
+        int w = static_cast<int>(width * factor);
+        int h = static_cast<int>(height * factor);
+        if (w <= 0 || h <= 0) continue;
+        reference = allocate_pixels(w, h, channels);
+        fixed = allocate_pixels(w, h, channels);
+        render_scale<DoubleBlend>(pixels, reference, factor);
+        render_scale<FixedBlend>(pixels, fixed, factor);
+        scale_error = std::max(scale_error, max_difference(reference, fixed));
+        free_pixels(reference);
+        free_pixels(fixed);
+    }
+    
+    bool ok = rotate_error <= 1 && scale_error <= 1;
+    std::cout << "\n=== Verificación de punto fijo ===" << std::endl;
+    std::cout << "Error máximo en rotación: " << rotate_error << " LSB" << std::endl;
+    std::cout << "Error máximo en escalado: " << scale_error << " LSB" << std::endl;
+    std::cout << "Resultado: " << (ok ? "OK (<= 1 LSB)" : "FALLO") << std::endl;
+    std::cout << "==================================" << std::endl;
+    return ok;
+}
+
+void ImageProcessor::compare_rotation_engines(double angle) const {
+    if (!pixels) return;
+    
+    unsigned char fill[4];
+    fill_for_channels(Pixel{0, 0, 0, 255}, channels, fill);
+    ImageBuffer resampled = allocate_pixels(width, height, channels);
+    ImageBuffer sheared = allocate_pixels(width, height, channels);
+    
+    auto resample_start = std::chrono::high_resolution_clock::now();
+    if (fixed_point) {
+        render_rotation<FixedBlend>(pixels, resampled, angle, fill);
+    } else {
+        render_rotation<DoubleBlend>(pixels, resampled, angle, fill);
+    }
+    auto resample_end = std::chrono::high_resolution_clock::now();
+    render_shear_rotation(pixels, sheared, angle, fill);
+    auto shear_end = std::chrono::high_resolution_clock::now();
+    
+    double mean = 0;
+    int max_diff = max_difference(resampled, sheared, &mean);
+    free_pixels(resampled);
+    free_pixels(sheared);
+    
+    auto resample_time = std::chrono::duration_cast<std::chrono::milliseconds>(resample_end - resample_start);
+    auto shear_time = std::chrono::duration_cast<std::chrono::milliseconds>(shear_end - resample_end);
     
-    // Liberar la imagen original y reemplazar con la escalada
-    free_pixels(pixels, old_height, using_buddy);
-    pixels = scaled;
+    std::cout << "\n=== Comparación de motores de rotación ===" << std::endl;
+    std::cout << "Ángulo: " << angle << " grados" << std::endl;
+    std::cout << "Remuestreo bilineal: " << resample_time.count() << " ms" << std::endl;
+    std::cout << "Tres cizallas (" << interpolation_name(interpolation) << "): "
+              << shear_time.count() << " ms" << std::endl;
+    std::cout << "Diferencia media: " << mean << " (máxima " << max_diff
+              << ", bordes suavizados incluidos)" << std::endl;
+    std::cout << "==========================================" << std::endl;
+}
+
+void ImageProcessor::compare_traversals(double angle) const {
+    if (!pixels) return;
+    
+    unsigned char fill[4];
+    fill_for_channels(Pixel{0, 0, 0, 255}, channels, fill);
+    AffineTransform inverse = AffineTransform::rotation(-angle, width / 2.0, height / 2.0);
+    int tile = output_tile > 0 ? output_tile : DEFAULT_OUTPUT_TILE;
+    
+    struct Variant {
+        const char* name;
+        int tile;
+        bool prefetch;
+    };
+    const Variant variants[] = {
+        {"Por filas", 0, false},
+        {"Por teselas", tile, false},
+        {"Por teselas + prefetch", tile, true}
+    };
+    
+    // Cada recorrido se mide tres veces y se queda el mejor tiempo; los
+    // contadores son los de esa misma pasada
+    CacheCounters counters;
+    ImageBuffer reference = allocate_pixels(width, height, channels);
+    ImageBuffer result = allocate_pixels(width, height, channels);
+    
+    std::cout << "\n=== Comparación de recorridos de la salida ===" << std::endl;
+    std::cout << "Ángulo: " << angle << " grados, " << width << "x" << height
+              << ", teselas de " << tile << " píxeles" << std::endl;
+    if (!counters.available()) {
+        std::cout << "Contadores de caché no disponibles en este sistema; solo tiempos" << std::endl;
+    }
+    
+    for (const Variant& variant : variants) {
+        ImageBuffer& out = variant.tile == 0 ? reference : result;
+        double best = 0;
+        CacheCounters::Reading misses{0, 0};
+        for (int run = 0; run < 3; ++run) {
+            counters.start();
+            auto start = std::chrono::high_resolution_clock::now();
+            if (fixed_point) {
+                render_warp<FixedBlend>(pixels, out, inverse, fill, variant.tile, variant.prefetch);
+            } else {
+                render_warp<DoubleBlend>(pixels, out, inverse, fill, variant.tile, variant.prefetch);
+            }
+            auto end = std::chrono::high_resolution_clock::now();
+            CacheCounters::Reading reading = counters.stop();
+            double ms = std::chrono::duration<double, std::milli>(end - start).count();
+            if (run == 0 || ms < best) {
+                best = ms;
+                misses = reading;
+            }
+        }
+        
+        std::cout << variant.name << ": " << best << " ms";
+        if (counters.has_l1d()) std::cout << ", fallos L1d " << misses.l1d_misses;
+        if (counters.has_llc()) std::cout << ", fallos LLC " << misses.llc_misses;
+        if (variant.tile != 0 && max_difference(reference, result, nullptr) != 0) {
+            std::cout << " (resultado distinto del recorrido por filas)";
+        }
+        std::cout << std::endl;
+    }
+    
+    free_pixels(reference);
+    free_pixels(result);
+    std::cout << "==============================================" << std::endl;
 }
 
 ImageProcessor::MemoryUsage ImageProcessor::get_memory_usage() {
@@ -319,18 +2108,18 @@ ImageProcessor::MemoryUsage ImageProcessor::get_memory_usage() {
     return mem;
 }
 
-void ImageProcessor::compare_performance(bool use_buddy) {
+void ImageProcessor::compare_performance() {
     // Medir memoria inicial
     MemoryUsage mem_before = get_memory_usage();
     
     // Medir tiempo de rotación
     auto rotate_start = std::chrono::high_resolution_clock::now();
-    rotate_internal(45.0, 0, 0, 0, 255); // Rotación de 45 grados con fondo negro
+    *this = rotated(45.0, 0, 0, 0, 255); // Rotación de 45 grados con fondo negro
     auto rotate_end = std::chrono::high_resolution_clock::now();
     
     // Medir tiempo de escalado
     auto scale_start = std::chrono::high_resolution_clock::now();
-    scale_internal(1.5); // Escalado de 1.5x
+    *this = scaled(1.5); // Escalado de 1.5x
     auto scale_end = std::chrono::high_resolution_clock::now();
     
     // Medir memoria final
@@ -343,7 +2132,7 @@ void ImageProcessor::compare_performance(bool use_buddy) {
     
     // Mostrar resultados
     std::cout << "\n=== COMPARACIÓN DE RENDIMIENTO ===" << std::endl;
-    std::cout << "Modo de memoria: " << (use_buddy ? "Buddy System" : "Convencional (new/delete)") << std::endl;
+    std::cout << "Modo de memoria: " << allocator.name << std::endl;
     std::cout << "Tiempo de rotación: " << rotate_time.count() << " ms" << std::endl;
     std::cout << "Tiempo de escalado: " << scale_time.count() << " ms" << std::endl;
     std::cout << "Memoria utilizada: " << memory_used << " KB" << std::endl;
@@ -355,7 +2144,31 @@ void ImageProcessor::print_info() const {
     std::cout << "\n=== Información de la Imagen ===" << std::endl;
     std::cout << "Archivo cargado" << std::endl;
     std::cout << "Dimensiones: " << width << " x " << height << " px" << std::endl;
-    std::cout << "Canales: " << channels << " (" << (channels == 3 ? "RGB" : "RGBA") << ")" << std::endl;
-    std::cout << "Gestión de memoria: " << (using_buddy ? "Buddy System" : "new/delete") << std::endl;
+    const char* channel_names[] = {"", "Gris", "Gris+Alfa", "RGB", "RGBA"};
+    std::cout << "Canales: " << channels << " (" << channel_names[channels] << ")" << std::endl;
+    std::cout << "Gestión de memoria: " << allocator.name << std::endl;
+    std::cout << "Distribución: " << (layout == Layout::Planar ? "planar (un plano por canal)" : "intercalada") << std::endl;
+    std::cout << "Interpolación: " << (fixed_point ? "punto fijo 8.8" : "doble precisión") << std::endl;
+    std::cout << "Núcleos bilineales: " << simd_level_name(get_simd_level()) << std::endl;
+    if (get_streaming_threshold() != SIZE_MAX) {
+        std::cout << "Escritura no temporal: salidas desde "
+                  << get_streaming_threshold() / (1024 * 1024) << " MB" << std::endl;
+    }
+    std::cout << "Filtro de interpolación: " << interpolation_name(interpolation) << std::endl;
+    const char* engine = "remuestreo bilineal";
+    if (interpolation == Interpolation::Nearest) {
+        engine = "vecino más cercano";
+    } else if (rotation_engine == RotationEngine::ThreeShear || interpolation != Interpolation::Bilinear) {
+        engine = "tres cizallas (Paeth)";
+    }
+    std::cout << "Motor de rotación: " << engine << std::endl;
+    if (border_apron > 0) {
+        const char* border_names[] = {"color de fondo", "replicar", "reflejar"};
+        std::cout << "Borde: " << border_names[static_cast<int>(border_mode)] << " (margen de "
+                  << border_apron << " px)" << std::endl;
+    }
+    if (tiled_rotation) {
+        std::cout << "Rotación sobre teselas de " << TiledImage::TILE << "x" << TiledImage::TILE << " px" << std::endl;
+    }
     std::cout << "===============================" << std::endl;
 }
\ No newline at end of file
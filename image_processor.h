@@ -1,10 +1,17 @@
 #ifndef IMAGE_PROCESSOR_H
 #define IMAGE_PROCESSOR_H
 
+#include <algorithm>
 #include <string>
 #include <vector>
 #include <memory>
-#include "buddy_allocator.h"
+#include "pixel_buffer_pool.h"
+#include "pixel_allocator.h"
+#include "image_buffer.h"
+#include "tiled_image.h"
+#include "resampler.h"
+#include "transform.h"
+#include "remap_cache.h"
 #include <sys/resource.h>
 
 class ImageProcessor {
@@ -13,20 +20,143 @@ public:
         unsigned char r, g, b, a;
     };
     
+    // Distribución de los canales en memoria
+    enum class Layout {
+        Interleaved,  // RGBARGBA... (AoS)
+        Planar        // RRR...GGG...BBB... (SoA), conversión al cargar/guardar
+    };
+    
     ImageProcessor();
     ~ImageProcessor();
     
-    bool load_image(const std::string& filename, bool use_buddy);
+    // Mover intercambia todos los campos con el destino: los píxeles cambian
+    // de dueño en O(1), sin copiarse, y los del destino se liberan con el
+    // objeto de origen
+    ImageProcessor(ImageProcessor&& other) noexcept;
+    ImageProcessor& operator=(ImageProcessor&& other) noexcept;
+    void swap(ImageProcessor& other) noexcept;
+    
+    bool load_image(const std::string& filename);
     bool save_image(const std::string& filename) const;
     
     void rotate(double angle, unsigned char fill_r = 0, unsigned char fill_g = 0, 
                 unsigned char fill_b = 0, unsigned char fill_a = 255);
     void scale(double factor);
     
+    // Variantes que no modifican la imagen: devuelven una nueva con el
+    // resultado y la misma configuración (motor de asignación, distribución,
+    // borde, filtro...), sin mensajes de tiempo. Sin imagen cargada (o con
+    // factor <= 0) la devuelta está vacía.
+    ImageProcessor rotated(double angle, unsigned char fill_r = 0, unsigned char fill_g = 0,
+                           unsigned char fill_b = 0, unsigned char fill_a = 255) const;
+    ImageProcessor scaled(double factor) const;
+    
+    // Transformación afín arbitraria (giro, escala, traslación...) en una
+    // sola pasada de remuestreo bilineal (o de vecino más cercano si es el
+    // filtro elegido). transform va del origen al destino;
+    // el resultado mide out_width x out_height (0: el tamaño actual) y lo que
+    // no cubre la imagen recibe el color de fondo.
+    void affine(const AffineTransform& transform, int out_width = 0, int out_height = 0,
+                unsigned char fill_r = 0, unsigned char fill_g = 0,
+                unsigned char fill_b = 0, unsigned char fill_a = 255);
+    
+    // Transformación proyectiva (homografía) con el mismo remuestreo
+    // bilineal, p. ej. para enderezar la foto de un documento: transform va
+    // del origen al destino y las zonas sin imagen reciben el color de fondo
+    void perspective(const Homography& transform, int out_width = 0, int out_height = 0,
+                     unsigned char fill_r = 0, unsigned char fill_g = 0,
+                     unsigned char fill_b = 0, unsigned char fill_a = 255);
+    
     int get_width() const { return width; }
     int get_height() const { return height; }
     int get_channels() const { return channels; }
     
+    // Motor de asignación de los buffers de píxeles (pixel_allocator.h; por
+    // defecto el pool compartido). Debe fijarse antes de load_image; cada
+    // buffer recuerda el motor que lo asignó.
+    template <class Engine>
+    void set_allocator() { allocator = PixelAllocator::of<Engine>(); }
+    const char* get_allocator_name() const { return allocator.name; }
+    
+    // Debe fijarse antes de load_image
+    void set_layout(Layout new_layout) { layout = new_layout; }
+    Layout get_layout() const { return layout; }
+    
+    // Qué ven los remuestreos (rotate, affine y perspective) fuera de la
+    // imagen: el color de fondo, el píxel del borde más cercano o la imagen
+    // reflejada en su borde (fedcba|abcdef|fedcba). Las muestras se toman de
+    // un margen de 'apron' píxeles reservado junto a la imagen y rellenado
+    // antes de cada transformación; los puntos más allá del margen reciben
+    // el color de fondo. Sin margen (por defecto) el borde es un corte
+    // neto: solo se interpolan los puntos con sus cuatro vecinos dentro.
+    enum class BorderMode {
+        Constant,   // Color de fondo (bordes suavizados con margen >= 1)
+        Replicate,  // Repetir el píxel del borde
+        Reflect     // Imagen en espejo respecto al borde
+    };
+    
+    void set_border_mode(BorderMode mode) { border_mode = mode; }
+    BorderMode get_border_mode() const { return border_mode; }
+    
+    // Debe fijarse antes de load_image
+    void set_border_apron(int pixels) { border_apron = std::max(0, pixels); }
+    int get_border_apron() const { return border_apron; }
+    
+    // Rotar muestreando una copia en teselas del origen (mejor localidad en
+    // imágenes grandes a costa de una pasada de conversión)
+    void set_tiled_rotation(bool enabled) { tiled_rotation = enabled; }
+    bool get_tiled_rotation() const { return tiled_rotation; }
+    
+    // Recorrido de la salida del remuestreo bilineal (rotate y affine): 0
+    // recorre filas completas; N > 0 produce la salida en teselas de N x N
+    // píxeles. Con ángulos grandes una fila de salida cruza miles de filas
+    // de origen y sus líneas ya no están en caché al llegar a la fila
+    // siguiente; la huella de origen de una tesela sí cabe. El resultado es
+    // idéntico con cualquier tamaño. Con prefetch (desactivado por defecto:
+    // el prefetcher hardware ya sigue cada fila de origen), tras cada tramo
+    // de fila se adelantan las líneas de origen del tramo siguiente.
+    void set_output_tiles(int tile_size) { output_tile = std::max(0, tile_size); }
+    int get_output_tiles() const { return output_tile; }
+    void set_tile_prefetch(bool enabled) { tile_prefetch = enabled; }
+    bool get_tile_prefetch() const { return tile_prefetch; }
+    
+    static const int DEFAULT_OUTPUT_TILE = 128;
+    
+    // Motor para ángulos que no son múltiplos de 90 grados
+    enum class RotationEngine {
+        Resample,     // Remuestreo bilineal 2D (acceso diagonal al origen)
+        ThreeShear    // Tres cizallas de Paeth: pasadas 1D por filas y columnas
+    };
+    
+    void set_rotation_engine(RotationEngine engine) { rotation_engine = engine; }
+    RotationEngine get_rotation_engine() const { return rotation_engine; }
+    
+    // Filtro para ampliar y rotar (al reducir se promedia por áreas). Los de
+    // orden superior rotan siempre con el motor de tres cizallas, cuyas
+    // pasadas 1D aplican un único juego de pesos por fila o columna. El
+    // vecino más cercano (vistas previas) copia píxeles sin interpolar en
+    // rotate, scale (también al reducir) y affine.
+    void set_interpolation(Interpolation filter) { interpolation = filter; }
+    Interpolation get_interpolation() const { return interpolation; }
+    
+    // Interpolación bilineal en punto fijo (pesos 8.8, aritmética entera) en
+    // lugar de la referencia en doble precisión
+    void set_fixed_point(bool enabled) { fixed_point = enabled; }
+    bool get_fixed_point() const { return fixed_point; }
+    
+    // Compara rotación y escalado en punto fijo contra la referencia en doble
+    // precisión sobre la imagen cargada; devuelve true si el error es <= 1 LSB
+    bool verify_fixed_point() const;
+    
+    // Mide los dos motores de rotación con el mismo ángulo sobre la imagen
+    // cargada, sin modificarla
+    void compare_rotation_engines(double angle) const;
+    
+    // Mide la rotación bilineal recorriendo la salida por filas, por
+    // teselas y por teselas con prefetch, con los fallos de caché de cada
+    // recorrido si el sistema expone los contadores hardware
+    void compare_traversals(double angle) const;
+    
     void print_info() const;
 
     struct MemoryUsage {
@@ -35,28 +165,131 @@ public:
     };
     
     static MemoryUsage get_memory_usage();
-    void compare_performance(bool use_buddy);
+    void compare_performance();
     
 private:
     int width, height, channels;
-    Pixel** pixels;
-    std::unique_ptr<BuddyAllocator> buddy_allocator;
-    bool using_buddy;
+    ImageBuffer pixels;
+    PixelAllocator allocator;
+    Layout layout;
+    BorderMode border_mode;
+    int border_apron;
+    bool tiled_rotation;
+    int output_tile;
+    bool tile_prefetch;
+    bool fixed_point;
+    RotationEngine rotation_engine;
+    Interpolation interpolation;
+    
+    ImageBuffer allocate_pixels(int w, int h, int c) const;
+    void free_pixels(ImageBuffer& buffer) const;
+    
+    // Imagen sin píxeles con la misma configuración que esta
+    ImageProcessor empty_like() const;
+    ImageBuffer copy_pixels() const;
+    
+    // Rellena el margen de src según el modo de borde y devuelve el alias
+    // con margen sobre el que muestrean los núcleos (desplazado apron
+    // píxeles respecto a src)
+    ImageBuffer bordered_source(const ImageBuffer& src, const unsigned char* fill) const;
+    
+    // Aritmética de la mezcla bilineal (definidas en image_processor.cpp)
+    struct DoubleBlend;  // Referencia en doble precisión
+    struct FixedBlend;   // Pesos en punto fijo 8.8
     
-    Pixel** allocate_pixels(int w, int h, bool use_buddy);
-    void free_pixels(Pixel** ptr, int h, bool use_buddy);
+    // Núcleos especializados por número de canales (1 a 4) y aritmética
+    template <int C, class Blend>
+    static void sample(const ImageView& src, double x, double y, unsigned char* out);
+    template <int C, class Blend>
+    static void sample(const TiledImage& src, double x, double y, unsigned char* out);
+    template <int C, class Blend, class Source>
+    // stream: salida con escritura no temporal (stream_store.h)
+    static void warp_kernel(const Source& src, const ImageView& dst,
+                            const AffineTransform& inverse, const unsigned char* fill,
+                            int tile, bool prefetch, bool stream);
     
-    Pixel interpolate(double x, double y) const;
-    Pixel get_pixel(int x, int y) const;
-    void set_pixel(int x, int y, const Pixel& pixel);
+    template <int C, class Blend, class Source>
+    static void perspective_kernel(const Source& src, const ImageView& dst,
+                                   const Homography& inverse, const unsigned char* fill);
     
-    void rotate_internal(double angle, unsigned char fill_r, unsigned char fill_g, 
-                        unsigned char fill_b, unsigned char fill_a);
-    void scale_internal(double factor);
+    // Vecino más cercano con coordenadas en punto fijo (sin mezcla)
+    template <int C>
+    static void nearest_kernel(const ImageView& src, const ImageView& dst,
+                               const AffineTransform& inverse, const unsigned char* fill);
+    static void render_nearest(const ImageBuffer& src, ImageBuffer& dst,
+                               const AffineTransform& inverse, const unsigned char* fill);
+    
+    // Núcleo por plano (un canal), en bloques de píxeles vectorizables
+    template <class Blend>
+    static void warp_plane(const ImageView& src, const ImageView& dst,
+                           const AffineTransform& inverse, unsigned char fill,
+                           int tile, bool prefetch, bool stream);
+    
+    // Rotaciones exactas en múltiplos de 90 grados (permutación de píxeles)
+    template <int C>
+    static void rotate_half_turn(const ImageView& image);
+    template <int C>
+    static void rotate_quarter(const ImageView& src, const ImageView& dst, int turns,
+                               int x_begin, int x_end, int y_begin, int y_end);
+    static void half_turn(const ImageBuffer& image);
+    ImageBuffer quarter_turn(int turns) const;
+    void rotate_right_angle(int turns);
+    
+    // Motor de tres cizallas: geometría de las pasadas intermedias y núcleo
+    struct ShearGeometry;
+    template <int C, int TAPS>
+    static void shear_kernel(const ImageView& src, const ImageView& pass1, const ImageView& pass2,
+                             const ImageView& dst, const ShearGeometry& geometry,
+                             Interpolation filter, const unsigned char* fill);
+    template <int TAPS>
+    static void shear_pixels(int pixel_bytes, const ImageView& src, const ImageView& pass1,
+                             const ImageView& pass2, const ImageView& dst,
+                             const ShearGeometry& geometry, Interpolation filter,
+                             const unsigned char* fill);
+    void render_shear_rotation(const ImageBuffer& src, ImageBuffer& dst, double angle,
+                               const unsigned char* fill) const;
+    
+    // Generan el resultado en dst sin modificar la imagen actual. inverse
+    // lleva cada píxel de dst a su posición en src.
+    template <class Blend>
+    void render_warp(const ImageBuffer& src, ImageBuffer& dst, const AffineTransform& inverse,
+                     const unsigned char* fill) const;
+    // Con un recorrido de la salida explícito (compare_traversals)
+    template <class Blend>
+    void render_warp(const ImageBuffer& src, ImageBuffer& dst, const AffineTransform& inverse,
+                     const unsigned char* fill, int tile, bool prefetch) const;
+    template <class Blend>
+    void render_perspective(const ImageBuffer& src, ImageBuffer& dst, const Homography& inverse,
+                            const unsigned char* fill) const;
+    
+    // Transformaciones repetidas: aplica la tabla de RemapCache si existe (o
+    // si la clave ya se pidió antes y se construye ahora); false si hay que
+    // remuestrear directamente
+    bool render_remapped(const ImageBuffer& src, ImageBuffer& dst, const Homography& inverse,
+                         RemapMode mode, const unsigned char* fill) const;
+    void render_affine(const ImageBuffer& src, ImageBuffer& dst, const AffineTransform& inverse,
+                       const unsigned char* fill) const;
+    template <class Blend>
+    void render_rotation(const ImageBuffer& src, ImageBuffer& dst, double angle,
+                         const unsigned char* fill) const;
+    template <class Blend>
+    void render_scale(const ImageBuffer& src, ImageBuffer& dst, double factor) const;
+    
+    // Resultado en un buffer nuevo, sin tocar pixels
+    ImageBuffer rotate_internal(double angle, const unsigned char* fill) const;
+    ImageBuffer scale_internal(double factor) const;
     
     // Deshabilitar copia
     ImageProcessor(const ImageProcessor&) = delete;
     ImageProcessor& operator=(const ImageProcessor&) = delete;
 };
 
+// Procesador con el motor de asignación fijado por su tipo, p. ej.
+// Image<BuddyPixels>
+template <class Engine>
+class Image : public ImageProcessor {
+public:
+    Image() { set_allocator<Engine>(); }
+};
+
 #endif
\ No newline at end of file
@@ -2,14 +2,44 @@
 #include <string>
 #include <vector>
 #include <chrono>
+#include <cmath>
+#include <cstdint>
 #include "image_processor.h"
+#include "simd_bilinear.h"
+#include "stream_store.h"
 
 void print_help() {
     std::cout << "Uso: ./image_processor entrada.jpg salida.jpg [opciones]\n";
     std::cout << "Opciones:\n";
     std::cout << "  -angulo <grados>    Rotar la imagen (ej. -angulo 45)\n";
-    std::cout << "  -escalar <factor>   Escalar la imagen (ej. -escalar 1.5)\n";
+    std::cout << "  -escalar <factor>   Escalar la imagen (ej. -escalar 1.5; < 1 promedia por áreas)\n";
+    std::cout << "  -perspectiva <x0 y0 x1 y1 x2 y2 x3 y3>\n";
+    std::cout << "                      Enderezar el cuadrilátero con esas esquinas (sup. izq.,\n";
+    std::cout << "                      sup. der., inf. der., inf. izq.) a toda la imagen\n";
     std::cout << "  -buddy              Usar Buddy System para gestión de memoria\n";
+    std::cout << "  -planar             Guardar la imagen en planos (un plano por canal)\n";
+    std::cout << "  -borde <modo>       Fuera de la imagen al rotar y transformar: constante (color\n";
+    std::cout << "                      de fondo), replicar o reflejar; bordes interpolados\n";
+    std::cout << "  -margen <px>        Margen de borde reservado junto a la imagen (defecto 1 con\n";
+    std::cout << "                      -borde; más allá se usa el color de fondo)\n";
+    std::cout << "  -teselas            Rotar muestreando el origen en teselas de 64x64\n";
+    std::cout << "  -recorrido <px>     Producir la salida de la rotación en teselas de px x px\n";
+    std::cout << "                      (defecto 128, 0 recorre filas completas)\n";
+    std::cout << "  -prefetch           Adelantar a la caché el origen de la tesela siguiente\n";
+    std::cout << "  -cizalla            Rotar con tres cizallas 1D (Paeth) en vez de remuestreo 2D\n";
+    std::cout << "  -comparar-motores   Medir ambos motores de rotación con el ángulo dado\n";
+    std::cout << "  -comparar-recorrido Medir la rotación por filas, por teselas y con prefetch\n";
+    std::cout << "  -interp <filtro>    Filtro al ampliar y rotar: bilineal, bicubica, lanczos3,\n";
+    std::cout << "                      vecino (sin interpolar, también al reducir)\n";
+    std::cout << "  -fijo               Interpolar con aritmética entera de punto fijo (8.8)\n";
+    std::cout << "  -verificar          Comparar punto fijo contra doble precisión (±1 LSB)\n";
+    std::cout << "  -simd <nivel>       Núcleos bilineales: auto, escalar, sse2, avx2, avx512\n";
+    std::cout << "  -escritura-directa <MB|no>\n";
+    std::cout << "                      Rotar sin pasar por la caché las salidas de al menos MB\n";
+    std::cout << "                      megabytes (defecto: tamaño de la caché L3)\n";
+    std::cout << "  -pool <MB>          Límite de la caché de buffers reutilizables (defecto 256)\n";
+    std::cout << "  -cache-remapeo <MB> Límite de la caché de tablas de transformaciones repetidas\n";
+    std::cout << "                      (defecto 256, 0 la desactiva)\n";
     std::cout << "  -help               Mostrar esta ayuda\n";
 }
 
@@ -25,6 +55,20 @@ int main(int argc, char* argv[]) {
     double rotate_angle = 0.0;
     double scale_factor = 1.0;
     bool use_buddy = false;
+    bool use_planar = false;
+    bool use_tiles = false;
+    ImageProcessor::BorderMode border_mode = ImageProcessor::BorderMode::Constant;
+    int border_apron = -1;  // Sin -margen: 1 px si se pide -borde
+    bool use_fixed = false;
+    bool verify_fixed = false;
+    bool use_shear = false;
+    bool compare_engines = false;
+    int output_tile = ImageProcessor::DEFAULT_OUTPUT_TILE;
+    bool tile_prefetch = false;
+    bool compare_traversals = false;
+    Interpolation interpolation = Interpolation::Bilinear;
+    bool use_perspective = false;
+    double corners[8];
     
     // Procesar argumentos
     for (int i = 3; i < argc; ++i) {
@@ -34,8 +78,77 @@ int main(int argc, char* argv[]) {
             rotate_angle = std::stod(argv[++i]);
         } else if (arg == "-escalar" && i + 1 < argc) {
             scale_factor = std::stod(argv[++i]);
+        } else if (arg == "-perspectiva" && i + 8 < argc) {
+            for (int k = 0; k < 8; ++k) {
+                corners[k] = std::stod(argv[++i]);
+            }
+            use_perspective = true;
         } else if (arg == "-buddy") {
             use_buddy = true;
+        } else if (arg == "-planar") {
+            use_planar = true;
+        } else if (arg == "-borde" && i + 1 < argc) {
+            std::string mode = argv[++i];
+            if (mode == "constante") border_mode = ImageProcessor::BorderMode::Constant;
+            else if (mode == "replicar") border_mode = ImageProcessor::BorderMode::Replicate;
+            else if (mode == "reflejar") border_mode = ImageProcessor::BorderMode::Reflect;
+            else {
+                std::cerr << "Modo de borde desconocido: " << mode << std::endl;
+                return 1;
+            }
+            if (border_apron < 0) border_apron = 1;
+        } else if (arg == "-margen" && i + 1 < argc) {
+            border_apron = std::max(0, std::stoi(argv[++i]));
+        } else if (arg == "-teselas") {
+            use_tiles = true;
+        } else if (arg == "-recorrido" && i + 1 < argc) {
+            output_tile = std::stoi(argv[++i]);
+        } else if (arg == "-prefetch") {
+            tile_prefetch = true;
+        } else if (arg == "-cizalla") {
+            use_shear = true;
+        } else if (arg == "-comparar-motores") {
+            compare_engines = true;
+        } else if (arg == "-comparar-recorrido") {
+            compare_traversals = true;
+        } else if (arg == "-interp" && i + 1 < argc) {
+            std::string filter = argv[++i];
+            if (filter == "vecino") interpolation = Interpolation::Nearest;
+            else if (filter == "bilineal") interpolation = Interpolation::Bilinear;
+            else if (filter == "bicubica") interpolation = Interpolation::Bicubic;
+            else if (filter == "lanczos3") interpolation = Interpolation::Lanczos3;
+            else {
+                std::cerr << "Filtro desconocido: " << filter << std::endl;
+                return 1;
+            }
+        } else if (arg == "-fijo") {
+            use_fixed = true;
+        } else if (arg == "-verificar") {
+            verify_fixed = true;
+        } else if (arg == "-simd" && i + 1 < argc) {
+            std::string level = argv[++i];
+            if (level == "auto") set_simd_level(detect_simd_level());
+            else if (level == "escalar") set_simd_level(SimdLevel::Scalar);
+            else if (level == "sse2") set_simd_level(SimdLevel::SSE2);
+            else if (level == "avx2") set_simd_level(SimdLevel::AVX2);
+            else if (level == "avx512") set_simd_level(SimdLevel::AVX512);
+            else {
+                std::cerr << "Nivel SIMD desconocido: " << level << std::endl;
+                return 1;
+            }
+        } else if (arg == "-escritura-directa" && i + 1 < argc) {
+            std::string threshold = argv[++i];
+            if (threshold == "no") {
+                set_streaming_threshold(SIZE_MAX);
+            } else {
+                set_streaming_threshold(std::stoul(threshold) * 1024 * 1024);
+            }
+        } else if (arg == "-pool" && i + 1 < argc) {
+            size_t pool_mb = std::stoul(argv[++i]);
+            PixelBufferPool::shared().set_max_cached_bytes(pool_mb * 1024 * 1024);
+        } else if (arg == "-cache-remapeo" && i + 1 < argc) {
+            size_t cache_mb = std::stoul(argv[++i]);
+            RemapCache::shared().set_max_cached_bytes(cache_mb * 1024 * 1024);
         } else if (arg == "-help") {
             print_help();
             return 0;
@@ -49,10 +162,28 @@ int main(int argc, char* argv[]) {
     // Procesar la imagen
     try {
         ImageProcessor processor;
+        if (use_buddy) {
+            processor.set_allocator<BuddyPixels>();
+        }
+        if (use_planar) {
+            processor.set_layout(ImageProcessor::Layout::Planar);
+        }
+        processor.set_border_mode(border_mode);
+        if (border_apron > 0) {
+            processor.set_border_apron(border_apron);
+        }
+        processor.set_tiled_rotation(use_tiles);
+        processor.set_output_tiles(output_tile);
+        processor.set_tile_prefetch(tile_prefetch);
+        processor.set_fixed_point(use_fixed);
+        processor.set_interpolation(interpolation);
+        if (use_shear) {
+            processor.set_rotation_engine(ImageProcessor::RotationEngine::ThreeShear);
+        }
         auto load_start = std::chrono::high_resolution_clock::now();
         
         // Cargar la imagen principal (DESCOMENTADO)
-        if (!processor.load_image(input_file, use_buddy)) {
+        if (!processor.load_image(input_file)) {
             std::cerr << "Error al cargar la imagen" << std::endl;
             return 1;
         }
@@ -65,18 +196,18 @@ int main(int argc, char* argv[]) {
             
             try {
                 // Ejecutar con Buddy System
-                ImageProcessor buddy_processor;
-                if (!buddy_processor.load_image(input_file, true)) {
+                Image<BuddyPixels> buddy_processor;
+                if (!buddy_processor.load_image(input_file)) {
                     throw std::runtime_error("Error al cargar imagen para prueba Buddy System");
                 }
-                buddy_processor.compare_performance(true);
+                buddy_processor.compare_performance();
                 
                 // Ejecutar con asignación convencional
-                ImageProcessor std_processor;
-                if (!std_processor.load_image(input_file, false)) {
+                Image<PooledPixels> std_processor;
+                if (!std_processor.load_image(input_file)) {
                     throw std::runtime_error("Error al cargar imagen para prueba convencional");
                 }
-                std_processor.compare_performance(false);
+                std_processor.compare_performance();
             } catch (const std::exception& e) {
                 std::cerr << "Error en pruebas comparativas: " << e.what() << std::endl;
                 return 1;
@@ -85,14 +216,66 @@ int main(int argc, char* argv[]) {
 
         processor.print_info();
         
+        // Contrastar la interpolación entera con la de referencia
+        if (verify_fixed && !processor.verify_fixed_point()) {
+            std::cerr << "La interpolación en punto fijo excede 1 LSB" << std::endl;
+            return 1;
+        }
+        
+        if (compare_engines) {
+            processor.compare_rotation_engines(rotate_angle != 0.0 ? rotate_angle : 30.0);
+        }
+        
+        if (compare_traversals) {
+            processor.compare_traversals(rotate_angle != 0.0 ? rotate_angle : 30.0);
+        }
+        
+        // La corrección de perspectiva va primero: el resto de operaciones
+        // trabaja sobre el documento ya enderezado
+        if (use_perspective) {
+            double w = processor.get_width() - 1;
+            double h = processor.get_height() - 1;
+            double target[8] = {0, 0, w, 0, w, h, 0, h};
+            Homography transform;
+            if (!Homography::from_quad(corners, target, transform)) {
+                std::cerr << "Las esquinas no forman un cuadrilátero válido" << std::endl;
+                return 1;
+            }
+            std::cout << "\nCorrigiendo perspectiva..." << std::endl;
+            processor.perspective(transform);
+        }
+        
+        // Girar y ampliar a la vez se resuelve con una única transformación
+        // afín: una sola interpolación y un solo buffer de salida. Quedan
+        // fuera los múltiplos de 90 grados (permutación exacta), las
+        // reducciones (promedio por áreas) y los filtros y motores que la
+        // transformación bilineal no reproduce. El vecino más cercano no
+        // promedia al reducir, así que se fusiona con cualquier factor.
+        double quarter_turns = rotate_angle / 90.0;
+        bool nearest = interpolation == Interpolation::Nearest;
+        bool fuse = rotate_angle != 0.0 && quarter_turns != std::floor(quarter_turns) &&
+                    ((scale_factor > 1.0 && !use_shear && interpolation == Interpolation::Bilinear) ||
+                     (scale_factor != 1.0 && nearest));
+        if (fuse) {
+            std::cout << "\nRotando " << rotate_angle << " grados y escalando con factor "
+                      << scale_factor << " en una sola pasada..." << std::endl;
+            AffineTransform transform =
+                AffineTransform::pixel_scaling(scale_factor, scale_factor) *
+                AffineTransform::rotation(rotate_angle, processor.get_width() / 2.0,
+                                          processor.get_height() / 2.0);
+            processor.affine(transform, static_cast<int>(processor.get_width() * scale_factor),
+                             static_cast<int>(processor.get_height() * scale_factor));
+            processor.print_info();
+        }
+        
         // Rotar si es necesario
-        if (rotate_angle != 0.0) {
+        if (rotate_angle != 0.0 && !fuse) {
             std::cout << "\nRotando imagen " << rotate_angle << " grados..." << std::endl;
             processor.rotate(rotate_angle);
         }
         
         // Escalar si es necesario
-        if (scale_factor != 1.0) {
+        if (scale_factor != 1.0 && !fuse) {
             std::cout << "\nEscalando imagen con factor " << scale_factor << "..." << std::endl;
             processor.scale(scale_factor);
             processor.print_info(); // Mostrar nuevas dimensiones
@@ -120,7 +303,19 @@ int main(int argc, char* argv[]) {
             std::cout << "Factor de escalado: " << scale_factor << std::endl;
         }
         std::cout << "Tiempo de guardado: " << save_time.count() << " ms" << std::endl;
-        std::cout << "Modo de memoria: " << (use_buddy ? "Buddy System" : "Convencional (new/delete)") << std::endl;
+        std::cout << "Modo de memoria: " << processor.get_allocator_name() << std::endl;
+        if (!use_buddy) {
+            PixelBufferPool::Stats pool_stats = PixelBufferPool::shared().get_stats();
+            std::cout << "Pool de buffers: " << pool_stats.hits << " reutilizados, "
+                      << pool_stats.misses << " nuevos, "
+                      << pool_stats.cached_bytes / 1024 << " KB en caché" << std::endl;
+        }
+        RemapCache::Stats remap_stats = RemapCache::shared().get_stats();
+        if (remap_stats.hits + remap_stats.builds > 0) {
+            std::cout << "Caché de remapeo: " << remap_stats.hits << " tablas reutilizadas, "
+                      << remap_stats.builds << " construidas, "
+                      << remap_stats.cached_bytes / 1024 << " KB en caché" << std::endl;
+        }
         std::cout << "=================================" << std::endl;
         
         std::cout << "\nImagen procesada guardada exitosamente como: " << output_file << std::endl;
@@ -0,0 +1,41 @@
+#include "pixel_allocator.h"
+#include <cstdint>
+#include <new>
+#include "buddy_allocator.h"
+#include "pixel_buffer_pool.h"
+
+void PooledPixels::allocate(ImageBuffer& buffer) {
+    // Un único bloque que se recicla entre imágenes del mismo tamaño y
+    // formato (ya alineado a 64 bytes)
+    unsigned format = buffer.channels | (buffer.planar ? 0x100u : 0u) |
+                      (static_cast<unsigned>(buffer.apron) << 9);
+    buffer.block = PixelBufferPool::shared().acquire(buffer.width, buffer.height, format,
+                                                     buffer.size_bytes());
+    buffer.data = static_cast<unsigned char*>(buffer.block) + buffer.data_offset();
+}
+
+void PooledPixels::release(ImageBuffer& buffer) {
+    // Devolver el bloque al pool para reutilizarlo en la siguiente imagen
+    PixelBufferPool::shared().release(buffer.block);
+}
+
+void BuddyPixels::allocate(ImageBuffer& buffer) {
+    size_t padded_size = buffer.size_bytes() + ImageBuffer::ROW_ALIGNMENT;
+    std::shared_ptr<BuddyAllocator> arena =
+        std::make_shared<BuddyAllocator>(padded_size * 2); // Asignar el doble para tener margen
+
+    // Todos los píxeles en un solo bloque, alineado a línea de caché
+    buffer.block = arena->allocate(padded_size);
+    if (!buffer.block) {
+        throw std::bad_alloc();
+    }
+    uintptr_t address = reinterpret_cast<uintptr_t>(buffer.block);
+    address = (address + ImageBuffer::ROW_ALIGNMENT - 1) & ~(uintptr_t)(ImageBuffer::ROW_ALIGNMENT - 1);
+    buffer.data = reinterpret_cast<unsigned char*>(address) + buffer.data_offset();
+    buffer.arena = arena;
+}
+
+void BuddyPixels::release(ImageBuffer& buffer) {
+    // El Buddy System libera su memoria en el destructor
+    buffer.arena.reset();
+}
@@ -0,0 +1,52 @@
+#ifndef PIXEL_ALLOCATOR_H
+#define PIXEL_ALLOCATOR_H
+
+#include "image_buffer.h"
+
+// Motores de asignación de los buffers de píxeles. Un motor es una clase sin
+// estado con tres funciones estáticas:
+//
+//   static const char* name();
+//   static void allocate(ImageBuffer& buffer);
+//   static void release(ImageBuffer& buffer);
+//
+// allocate recibe el buffer con la geometría ya fijada (size_bytes() y
+// data_offset() válidos) y debe dejar en block el bloque reservado y en data
+// su píxel (0, 0), alineado a ImageBuffer::ROW_ALIGNMENT. Si el motor
+// necesita estado propio por buffer (un pool, una región mapeada) lo guarda
+// en arena, que se destruye con el buffer. release devuelve el bloque; la
+// vista del buffer la vacía el llamador.
+//
+// ImageProcessor no conoce los motores: trabaja con un PixelAllocator
+// generado a partir del tipo del motor, de modo que uno nuevo (TLSF, slab,
+// mmap...) se añade escribiendo su clase, sin tocar el procesador.
+
+// Pool compartido de buffers reutilizables (pixel_buffer_pool.h)
+struct PooledPixels {
+    static const char* name() { return "pool de buffers"; }
+    static void allocate(ImageBuffer& buffer);
+    static void release(ImageBuffer& buffer);
+};
+
+// Un Buddy System propio por buffer, de modo que la imagen de origen sigue
+// siendo válida mientras se genera la de destino
+struct BuddyPixels {
+    static const char* name() { return "Buddy System"; }
+    static void allocate(ImageBuffer& buffer);
+    static void release(ImageBuffer& buffer);
+};
+
+// Motor elegido en tiempo de compilación, reducido a sus funciones para
+// guardarlo en el procesador y en cada buffer
+struct PixelAllocator {
+    const char* name;
+    void (*allocate)(ImageBuffer& buffer);
+    void (*release)(ImageBuffer& buffer);
+
+    template <class Engine>
+    static PixelAllocator of() {
+        return PixelAllocator{Engine::name(), &Engine::allocate, &Engine::release};
+    }
+};
+
+#endif
@@ -0,0 +1,99 @@
+#include "pixel_buffer_pool.h"
+#include <cstdlib>
+#include <new>
+
+PixelBufferPool::PixelBufferPool(size_t max_bytes)
+    : lru_head(nullptr), lru_tail(nullptr), max_cached_bytes(max_bytes), stats{0, 0, 0, 0} {}
+
+PixelBufferPool::~PixelBufferPool() {
+    clear();
+}
+
+void* PixelBufferPool::acquire(int width, int height, unsigned format, size_t bytes) {
+    // Buscar desde el más reciente un buffer con la misma clave
+    for (Header* header = lru_head; header; header = header->next) {
+        if (header->width == width && header->height == height &&
+            header->format == format && header->bytes == bytes) {
+            unlink(header);
+            stats.cached_bytes -= header->bytes;
+            stats.hits++;
+            return header + 1;
+        }
+    }
+
+    stats.misses++;
+    void* memory = nullptr;
+    if (posix_memalign(&memory, alignof(Header), sizeof(Header) + bytes) != 0) {
+        // Sin memoria: vaciar la caché y reintentar una vez
+        clear();
+        if (posix_memalign(&memory, alignof(Header), sizeof(Header) + bytes) != 0) {
+            throw std::bad_alloc();
+        }
+    }
+
+    Header* header = static_cast<Header*>(memory);
+    header->prev = nullptr;
+    header->next = nullptr;
+    header->width = width;
+    header->height = height;
+    header->format = format;
+    header->bytes = bytes;
+    return header + 1;
+}
+
+void PixelBufferPool::release(void* ptr) {
+    if (!ptr) return;
+
+    Header* header = static_cast<Header*>(ptr) - 1;
+    if (header->bytes > max_cached_bytes) {
+        stats.evictions++;
+        free(header);
+        return;
+    }
+
+    push_front(header);
+    stats.cached_bytes += header->bytes;
+    evict_to(max_cached_bytes);
+}
+
+void PixelBufferPool::set_max_cached_bytes(size_t max_bytes) {
+    max_cached_bytes = max_bytes;
+    evict_to(max_cached_bytes);
+}
+
+void PixelBufferPool::clear() {
+    evict_to(0);
+}
+
+PixelBufferPool& PixelBufferPool::shared() {
+    static PixelBufferPool pool(DEFAULT_MAX_CACHED_BYTES);
+    return pool;
+}
+
+void PixelBufferPool::unlink(Header* header) {
+    if (header->prev) header->prev->next = header->next;
+    else lru_head = header->next;
+    if (header->next) header->next->prev = header->prev;
+    else lru_tail = header->prev;
+    header->prev = nullptr;
+    header->next = nullptr;
+}
+
+void PixelBufferPool::push_front(Header* header) {
+    header->prev = nullptr;
+    header->next = lru_head;
+    if (lru_head) lru_head->prev = header;
+    lru_head = header;
+    if (!lru_tail) lru_tail = header;
+}
+
+void PixelBufferPool::evict_to(size_t limit) {
+    // Descartar desde el menos usado hasta quedar dentro del límite
+    while (lru_tail && stats.cached_bytes > limit) {
+        Header* victim = lru_tail;
+        unlink(victim);
+        stats.cached_bytes -= victim->bytes;
+        stats.evictions++;
+        free(victim);
+    }
+}
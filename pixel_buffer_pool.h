@@ -0,0 +1,64 @@
+#ifndef PIXEL_BUFFER_POOL_H
+#define PIXEL_BUFFER_POOL_H
+
+#include <cstddef>
+
+// Pool de buffers de píxeles reutilizables entre imágenes de un lote.
+// Los buffers liberados se guardan indexados por (ancho, alto, formato) y se
+// entregan de nuevo al pedir otro buffer con la misma clave, de modo que en
+// régimen estable no se llama al asignador del sistema. El total de bytes en
+// caché está limitado; al superarlo se descartan los buffers menos usados (LRU).
+class PixelBufferPool {
+public:
+    struct Stats {
+        size_t hits;          // Peticiones servidas desde la caché
+        size_t misses;        // Peticiones que requirieron memoria nueva
+        size_t evictions;     // Buffers descartados por el límite LRU
+        size_t cached_bytes;  // Bytes actualmente en caché
+    };
+
+    explicit PixelBufferPool(size_t max_cached_bytes);
+    ~PixelBufferPool();
+
+    // 'format' es una etiqueta opaca definida por el llamador (p. ej. bytes por píxel)
+    void* acquire(int width, int height, unsigned format, size_t bytes);
+    void release(void* ptr);
+
+    void set_max_cached_bytes(size_t max_bytes);
+    size_t get_max_cached_bytes() const { return max_cached_bytes; }
+    void clear();
+
+    Stats get_stats() const { return stats; }
+
+    // Pool compartido por todas las imágenes del proceso
+    static PixelBufferPool& shared();
+
+    static const size_t DEFAULT_MAX_CACHED_BYTES = 256u * 1024u * 1024u;
+
+private:
+    // Cabecera situada justo antes de los datos; enlaza el buffer en la lista
+    // LRU sin necesidad de nodos adicionales (ocupa una línea de caché para
+    // mantener los datos alineados a 64 bytes).
+    struct alignas(64) Header {
+        Header* prev;
+        Header* next;
+        int width;
+        int height;
+        unsigned format;
+        size_t bytes;
+    };
+
+    Header* lru_head;  // Más reciente
+    Header* lru_tail;  // Menos reciente
+    size_t max_cached_bytes;
+    Stats stats;
+
+    void unlink(Header* header);
+    void push_front(Header* header);
+    void evict_to(size_t limit);
+
+    PixelBufferPool(const PixelBufferPool&) = delete;
+    PixelBufferPool& operator=(const PixelBufferPool&) = delete;
+};
+
+#endif
@@ -0,0 +1,78 @@
+#include "remap_cache.h"
+#include <algorithm>
+
+bool RemapKey::operator==(const RemapKey& other) const {
+    return src_width == other.src_width && src_height == other.src_height &&
+           src_stride == other.src_stride && pixel_bytes == other.pixel_bytes &&
+           dst_width == other.dst_width && dst_height == other.dst_height &&
+           mode == other.mode && std::equal(inverse, inverse + 9, other.inverse);
+}
+
+size_t RemapTable::bytes() const {
+    return (begin.size() + end.size()) * sizeof(int) +
+           offset.size() * sizeof(uint32_t) +
+           fixed_weight.size() * sizeof(uint16_t) +
+           float_weight.size() * sizeof(float);
+}
+
+RemapCache::RemapCache(size_t max_bytes)
+    : max_cached_bytes(max_bytes), stats{0, 0, 0, 0, 0} {}
+
+std::shared_ptr<const RemapTable> RemapCache::lookup(const RemapKey& key, size_t table_bytes,
+                                                     bool& build) {
+    build = false;
+    for (auto it = tables.begin(); it != tables.end(); ++it) {
+        if ((*it)->key == key) {
+            // Pasa a ser la más reciente
+            tables.splice(tables.begin(), tables, it);
+            stats.hits++;
+            return tables.front();
+        }
+    }
+
+    stats.misses++;
+    auto it = std::find(seen.begin(), seen.end(), key);
+    if (it != seen.end()) {
+        seen.erase(it);
+        build = table_bytes <= max_cached_bytes;
+    } else {
+        seen.push_front(key);
+        if (seen.size() > SEEN_KEYS) seen.pop_back();
+    }
+    return nullptr;
+}
+
+void RemapCache::insert(const std::shared_ptr<const RemapTable>& table) {
+    size_t bytes = table->bytes();
+    stats.builds++;
+    if (bytes > max_cached_bytes) {
+        return;
+    }
+    tables.push_front(table);
+    stats.cached_bytes += bytes;
+    evict_to(max_cached_bytes);
+}
+
+void RemapCache::set_max_cached_bytes(size_t max_bytes) {
+    max_cached_bytes = max_bytes;
+    evict_to(max_cached_bytes);
+}
+
+void RemapCache::clear() {
+    evict_to(0);
+    seen.clear();
+}
+
+RemapCache& RemapCache::shared() {
+    static RemapCache cache(DEFAULT_MAX_CACHED_BYTES);
+    return cache;
+}
+
+void RemapCache::evict_to(size_t limit) {
+    // Las tablas en uso siguen vivas por su shared_ptr hasta que se sueltan
+    while (!tables.empty() && stats.cached_bytes > limit) {
+        stats.cached_bytes -= tables.back()->bytes();
+        stats.evictions++;
+        tables.pop_back();
+    }
+}
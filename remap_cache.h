@@ -0,0 +1,97 @@
+#ifndef REMAP_CACHE_H
+#define REMAP_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <vector>
+
+// Muestreo que codifica una tabla de remapeo
+enum class RemapMode {
+    Nearest,         // Un píxel de origen por píxel de salida
+    BilinearFixed,   // Cuatro vecinos con pesos 8.8
+    BilinearFloat    // Cuatro vecinos con pesos en float
+};
+
+// Identifica una transformación sobre una geometría concreta: los
+// desplazamientos de la tabla dependen del paso de fila y de los bytes por
+// píxel del origen, así que forman parte de la clave.
+struct RemapKey {
+    int src_width;
+    int src_height;
+    size_t src_stride;
+    int pixel_bytes;
+    int dst_width;
+    int dst_height;
+    RemapMode mode;
+    double inverse[9];     // Homografía inversa (del destino al origen)
+
+    bool operator==(const RemapKey& other) const;
+};
+
+// Mapa precalculado de una transformación: para cada fila, el tramo
+// [begin, end) con origen dentro de la imagen (el resto es color de fondo) y,
+// para cada píxel del tramo, el desplazamiento en bytes de su vecino superior
+// izquierdo (o del píxel copiado) y los pesos de la mezcla. Aplicarlo a otra
+// imagen de la misma geometría es una recogida guiada por la tabla, sin
+// aritmética de coordenadas.
+struct RemapTable {
+    RemapKey key;
+    std::vector<int> begin;             // Por fila
+    std::vector<int> end;
+    std::vector<uint32_t> offset;       // Píxeles de los tramos, fila tras fila
+    std::vector<uint16_t> fixed_weight; // fx, fy intercalados (BilinearFixed)
+    std::vector<float> float_weight;    // dx, dy intercalados (BilinearFloat)
+
+    size_t bytes() const;
+};
+
+// Caché LRU de tablas de remapeo para lotes de imágenes iguales con la misma
+// transformación. Una tabla cuesta más que una pasada directa, así que solo
+// se construye cuando la misma clave se pide por segunda vez; las claves
+// vistas una sola vez se recuerdan en una lista corta. El total de bytes de
+// las tablas está limitado y al superarlo se descartan las menos usadas.
+class RemapCache {
+public:
+    struct Stats {
+        size_t hits;          // Transformaciones resueltas con una tabla
+        size_t misses;        // Peticiones sin tabla en caché
+        size_t builds;        // Tablas construidas
+        size_t evictions;     // Tablas descartadas por el límite LRU
+        size_t cached_bytes;  // Bytes actualmente en caché
+    };
+
+    explicit RemapCache(size_t max_cached_bytes);
+
+    // Tabla de la clave si está en caché. Si no, build indica si conviene
+    // construirla (clave ya pedida antes y tabla de table_bytes dentro del
+    // límite) para entregarla con insert().
+    std::shared_ptr<const RemapTable> lookup(const RemapKey& key, size_t table_bytes, bool& build);
+    void insert(const std::shared_ptr<const RemapTable>& table);
+
+    void set_max_cached_bytes(size_t max_bytes);
+    size_t get_max_cached_bytes() const { return max_cached_bytes; }
+    void clear();
+
+    Stats get_stats() const { return stats; }
+
+    // Caché compartida por todas las imágenes del proceso
+    static RemapCache& shared();
+
+    static const size_t DEFAULT_MAX_CACHED_BYTES = 256u * 1024u * 1024u;
+    static const size_t SEEN_KEYS = 16;
+
+private:
+    std::list<std::shared_ptr<const RemapTable>> tables;  // Más reciente primero
+    std::list<RemapKey> seen;                             // Pedidas una vez, más reciente primero
+    size_t max_cached_bytes;
+    Stats stats;
+
+    void evict_to(size_t limit);
+
+    RemapCache(const RemapCache&) = delete;
+    RemapCache& operator=(const RemapCache&) = delete;
+};
+
+#endif
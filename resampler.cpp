@@ -0,0 +1,529 @@
+#include "resampler.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+// Unidad de los pesos en punto fijo de los filtros de orden superior
+static const int FILTER_ONE = 1 << 12;
+
+int interpolation_taps(Interpolation filter) {
+    switch (filter) {
+        case Interpolation::Nearest: return 1;
+        case Interpolation::Bicubic: return 4;
+        case Interpolation::Lanczos3: return 6;
+        default: return 2;
+    }
+}
+
+double interpolation_weight(Interpolation filter, double distance) {
+    double x = std::fabs(distance);
+    switch (filter) {
+        case Interpolation::Nearest:
+            return x < 0.5 ? 1 : 0;
+        case Interpolation::Bicubic: {
+            const double a = -0.5;
+            if (x < 1) return ((a + 2) * x - (a + 3)) * x * x + 1;
+            if (x < 2) return ((a * x - 5 * a) * x + 8 * a) * x - 4 * a;
+            return 0;
+        }
+        case Interpolation::Lanczos3: {
+            if (x < 1e-8) return 1;
+            if (x >= 3) return 0;
+            double px = M_PI * x;
+            return 3 * std::sin(px) * std::sin(px / 3) / (px * px);
+        }
+        default:
+            return x < 1 ? 1 - x : 0;
+    }
+}
+
+const char* interpolation_name(Interpolation filter) {
+    switch (filter) {
+        case Interpolation::Nearest: return "vecino más cercano";
+        case Interpolation::Bicubic: return "bicúbica";
+        case Interpolation::Lanczos3: return "Lanczos-3";
+        default: return "bilineal";
+    }
+}
+
+Resampler::Resampler(int src_width, int src_height, int dst_width, int dst_height,
+                     double factor, bool fixed, Interpolation filter)
+    : area(factor < 1 && filter != Interpolation::Nearest),
+      nearest(filter == Interpolation::Nearest),
+      ratio(0),
+      scale(!fixed ? 1.0f : (filter == Interpolation::Bilinear ? 1.0f / 65536.0f
+                                                               : 1.0f / (FILTER_ONE * FILTER_ONE))),
+      bias(filter == Interpolation::Bilinear ? 0.0f : 0.5f) {
+    if (nearest) {
+        if (factor >= 2 && factor == std::floor(factor)) {
+            ratio = static_cast<int>(factor);
+        }
+        columns = nearest_table(src_width, dst_width, factor);
+        rows = nearest_table(src_height, dst_height, factor);
+    } else if ((factor == 0.5 || factor == 0.25) && dst_width * (1 / factor) <= src_width &&
+        dst_height * (1 / factor) <= src_height) {
+        // La media de bloques coincide exactamente con el promedio por áreas
+        ratio = static_cast<int>(1 / factor);
+    } else if ((factor == 2 || factor == 3) && filter == Interpolation::Bilinear) {
+        // Los bordes siguen las tablas bilineales (8.8)
+        ratio = static_cast<int>(factor);
+        columns = bilinear_table(src_width, dst_width, factor, true);
+        rows = bilinear_table(src_height, dst_height, factor, true);
+    } else if (area) {
+        area_columns = area_table(src_width, dst_width, factor);
+        area_rows = area_table(src_height, dst_height, factor);
+    } else if (filter == Interpolation::Bilinear) {
+        columns = bilinear_table(src_width, dst_width, factor, fixed);
+        rows = bilinear_table(src_height, dst_height, factor, fixed);
+    } else {
+        columns = filter_table(src_width, dst_width, factor, fixed, filter);
+        rows = filter_table(src_height, dst_height, factor, fixed, filter);
+    }
+}
+
+// Posición de origen (i + 0.5) / factor - 0.5 con los mismos límites que la
+// interpolación bilineal 2D: por debajo de 0 se repite el borde y el vecino
+// siguiente se acota al último índice
+Resampler::AxisTable Resampler::bilinear_table(int src_size, int dst_size, double factor,
+                                               bool fixed) {
+    AxisTable table;
+    table.taps = 2;
+    table.index.resize(static_cast<size_t>(dst_size) * 2);
+    table.weight.resize(static_cast<size_t>(dst_size) * 2);
+
+    for (int i = 0; i < dst_size; ++i) {
+        double s = std::max(0.0, (i + 0.5) / factor - 0.5);
+        int i0 = std::min(static_cast<int>(s), src_size - 1);
+        double d = std::min(1.0, s - i0);
+
+        table.index[i * 2] = i0;
+        table.index[i * 2 + 1] = std::min(i0 + 1, src_size - 1);
+        if (fixed) {
+            int f = static_cast<int>(d * 256 + 0.5);
+            table.weight[i * 2] = static_cast<float>(256 - f);
+            table.weight[i * 2 + 1] = static_cast<float>(f);
+        } else {
+            table.weight[i * 2] = static_cast<float>(1 - d);
+            table.weight[i * 2 + 1] = static_cast<float>(d);
+        }
+    }
+    return table;
+}
+
+// Filtros de orden superior: las muestras rodean la posición de origen
+// (taps / 2 a cada lado), los índices fuera de la imagen repiten el borde y
+// los pesos se normalizan para que sumen 1 (FILTER_ONE en punto fijo,
+// repartiendo el error de redondeo en la muestra más cercana). Con 8 bits
+// los seis pesos de Lanczos-3 acumularían más de 1 LSB de error.
+Resampler::AxisTable Resampler::filter_table(int src_size, int dst_size, double factor,
+                                             bool fixed, Interpolation filter) {
+    AxisTable table;
+    int taps = interpolation_taps(filter);
+    table.taps = taps;
+    table.index.resize(static_cast<size_t>(dst_size) * taps);
+    table.weight.resize(static_cast<size_t>(dst_size) * taps);
+
+    for (int i = 0; i < dst_size; ++i) {
+        double s = (i + 0.5) / factor - 0.5;
+        int first = static_cast<int>(std::floor(s)) - (taps / 2 - 1);
+        int* index = &table.index[static_cast<size_t>(i) * taps];
+        float* weight = &table.weight[static_cast<size_t>(i) * taps];
+
+        double w[8];
+        double total = 0;
+        for (int k = 0; k < taps; ++k) {
+            w[k] = interpolation_weight(filter, s - (first + k));
+            total += w[k];
+            index[k] = std::min(std::max(first + k, 0), src_size - 1);
+        }
+        if (fixed) {
+            int sum = 0;
+            int nearest = taps / 2 - 1 + (s - std::floor(s) >= 0.5 ? 1 : 0);
+            for (int k = 0; k < taps; ++k) {
+                int q = static_cast<int>(std::lround(w[k] / total * FILTER_ONE));
+                weight[k] = static_cast<float>(q);
+                sum += q;
+            }
+            weight[nearest] += static_cast<float>(FILTER_ONE - sum);
+        } else {
+            for (int k = 0; k < taps; ++k) {
+                weight[k] = static_cast<float>(w[k] / total);
+            }
+        }
+    }
+    return table;
+}
+
+// Píxel de origen que contiene el centro (i + 0.5) / factor de cada salida
+Resampler::AxisTable Resampler::nearest_table(int src_size, int dst_size, double factor) {
+    AxisTable table;
+    table.taps = 1;
+    table.index.resize(dst_size);
+    for (int i = 0; i < dst_size; ++i) {
+        int s = static_cast<int>((i + 0.5) / factor);
+        table.index[i] = std::min(s, src_size - 1);
+    }
+    return table;
+}
+
+// La salida i cubre el intervalo de origen [i / factor, (i + 1) / factor),
+// de ancho mayor que un píxel, así que cada píxel de origen [s, s + 1) se
+// reparte entre la salida que lo contiene y como mucho la siguiente. Los
+// pesos llevan ya el factor, de modo que los de cada salida suman 1.
+Resampler::AreaTable Resampler::area_table(int src_size, int dst_size, double factor) {
+    AreaTable table;
+    table.target.resize(src_size);
+    table.first.resize(src_size);
+    table.second.resize(src_size);
+
+    for (int s = 0; s < src_size; ++s) {
+        int t = static_cast<int>(s * factor);
+        double boundary = (t + 1) / factor;
+        if (boundary <= s) {
+            boundary = (++t + 1) / factor;
+        }
+        double inside = std::min(1.0, boundary - s);
+
+        table.target[s] = std::min(t, dst_size);
+        table.first[s] = static_cast<float>(inside * factor);
+        table.second[s] = static_cast<float>((1 - inside) * factor);
+    }
+    return table;
+}
+
+// Pasada horizontal sobre una fila de origen ya convertida a float. Las
+// tablas están expandidas a un valor por canal ([k][j]: desplazamiento y peso
+// de la muestra k del valor de salida j), así que el bucle es plano e igual
+// para cualquier número de canales
+template <int TAPS>
+static void horizontal_pass(const float* row, const int* offsets, const float* weights,
+                            size_t count, float* out) {
+    for (size_t j = 0; j < count; ++j) {
+        float sum = 0;
+        for (int k = 0; k < TAPS; ++k) {
+            sum += row[offsets[k * count + j]] * weights[k * count + j];
+        }
+        out[j] = sum;
+    }
+}
+
+template <int C, int TAPS>
+void Resampler::run_kernel(const ImageView& src, const ImageView& dst) const {
+    const size_t row_values = static_cast<size_t>(dst.width) * C;
+
+    // Anillo de filas intermedias: la fila de origen r ocupa la ranura r % TAPS.
+    // Las ventanas de filas avanzan de forma monótona, así que al cargar una
+    // fila solo se expulsa otra que ya no se volverá a usar.
+    std::vector<float> ring(TAPS * row_values);
+    int cached[TAPS];
+    std::fill(cached, cached + TAPS, -1);
+
+    // Tabla horizontal expandida a valores (píxel * C + canal)
+    std::vector<int> offsets(TAPS * row_values);
+    std::vector<float> weights(TAPS * row_values);
+    std::vector<float> source_row(static_cast<size_t>(src.width) * C);
+    for (int x = 0; x < dst.width; ++x) {
+        for (int k = 0; k < TAPS; ++k) {
+            for (int c = 0; c < C; ++c) {
+                offsets[k * row_values + x * C + c] = columns.index[x * TAPS + k] * C + c;
+                weights[k * row_values + x * C + c] = columns.weight[x * TAPS + k];
+            }
+        }
+    }
+
+    for (int y = 0; y < dst.height; ++y) {
+        const int* index = &rows.index[static_cast<size_t>(y) * TAPS];
+        const float* weight = &rows.weight[static_cast<size_t>(y) * TAPS];
+
+        const float* line[TAPS];
+        for (int k = 0; k < TAPS; ++k) {
+            int slot = index[k] % TAPS;
+            float* cache = &ring[slot * row_values];
+            if (cached[slot] != index[k]) {
+                const unsigned char* in = src.row(index[k]);
+                for (size_t i = 0; i < source_row.size(); ++i) {
+                    source_row[i] = in[i];
+                }
+                horizontal_pass<TAPS>(source_row.data(), offsets.data(), weights.data(),
+                                      row_values, cache);
+                cached[slot] = index[k];
+            }
+            line[k] = cache;
+        }
+
+        // Pasada vertical: un bucle plano sobre todos los valores de la fila
+        unsigned char* out = dst.row(y);
+        for (size_t j = 0; j < row_values; ++j) {
+            float value = 0;
+            for (int k = 0; k < TAPS; ++k) {
+                value += line[k][j] * weight[k];
+            }
+            value = value * scale + bias;
+            value = value < 0.0f ? 0.0f : (value > 255.0f ? 255.0f : value);
+            out[j] = static_cast<unsigned char>(value);
+        }
+    }
+}
+
+// Promedio por áreas con sumas acumuladas: cada fila de origen se reduce en
+// horizontal una vez (repartiendo cada píxel entre sus dos columnas de
+// salida) y se suma a las dos filas de salida que toca. Una fila de salida
+// se emite en cuanto llega la primera fila de origen que ya no la toca, así
+// que el coste es O(1) por píxel de origen sea cual sea el factor.
+template <int C>
+void Resampler::run_area(const ImageView& src, const ImageView& dst) const {
+    // Dos columnas de sobra para las contribuciones que caen fuera del destino
+    const size_t row_values = static_cast<size_t>(dst.width + 2) * C;
+    const size_t out_values = static_cast<size_t>(dst.width) * C;
+    std::vector<float> reduced(row_values);
+    std::vector<float> current(row_values, 0.0f);
+    std::vector<float> next(row_values, 0.0f);
+
+    auto emit = [&](int y) {
+        unsigned char* out = dst.row(y);
+        for (size_t j = 0; j < out_values; ++j) {
+            float value = current[j] + 0.5f;
+            out[j] = static_cast<unsigned char>(value > 255.0f ? 255.0f : value);
+        }
+    };
+
+    int y = 0;
+    for (int r = 0; r < src.height && y < dst.height; ++r) {
+        int target = area_rows.target[r];
+        while (y < target && y < dst.height) {
+            emit(y++);
+            current.swap(next);
+            std::fill(next.begin(), next.end(), 0.0f);
+        }
+        if (y >= dst.height) {
+            break;
+        }
+
+        std::fill(reduced.begin(), reduced.end(), 0.0f);
+        const unsigned char* in = src.row(r);
+        for (int x = 0; x < src.width; ++x) {
+            float* first = &reduced[static_cast<size_t>(area_columns.target[x]) * C];
+            float w0 = area_columns.first[x];
+            float w1 = area_columns.second[x];
+            for (int c = 0; c < C; ++c) {
+                float value = in[x * C + c];
+                first[c] += value * w0;
+                first[C + c] += value * w1;
+            }
+        }
+
+        float w0 = area_rows.first[r];
+        float w1 = area_rows.second[r];
+        for (size_t j = 0; j < out_values; ++j) {
+            current[j] += reduced[j] * w0;
+            next[j] += reduced[j] * w1;
+        }
+    }
+    while (y < dst.height) {
+        emit(y++);
+        current.swap(next);
+        std::fill(next.begin(), next.end(), 0.0f);
+    }
+}
+
+// Ampliación bilineal x N: la salida N * m + r mezcla los píxeles de origen
+// m + offset[r] y el siguiente con los pesos fijos de la fase r, que se
+// toman de la tabla en m = 1 y valen para todo el interior. Solo las
+// primeras y últimas posiciones, acotadas al borde, recurren a la tabla.
+// La pasada horizontal deja sumas de 16 bits (8.8) por fila de origen y la
+// vertical las combina en 32 bits, ambas en bucles planos vectorizables.
+template <int C, int N>
+void Resampler::run_upscale(const ImageView& src, const ImageView& dst) const {
+    const size_t row_values = static_cast<size_t>(dst.width) * C;
+
+    int offset[N] = {};
+    unsigned w0[N] = {}, w1[N] = {};
+    int m_begin = 1;
+    int m_end = 1;
+    if (src.width >= 3) {
+        int last = 0;
+        for (int r = 0; r < N; ++r) {
+            offset[r] = columns.index[(N + r) * 2] - 1;
+            w0[r] = static_cast<unsigned>(columns.weight[(N + r) * 2]);
+            w1[r] = static_cast<unsigned>(columns.weight[(N + r) * 2 + 1]);
+            last = std::max(last, offset[r] + 1);
+        }
+        m_end = std::max(m_begin, src.width - last);
+    }
+
+    uint16_t* ring[2];
+    std::vector<uint16_t> storage(2 * row_values);
+    ring[0] = storage.data();
+    ring[1] = storage.data() + row_values;
+    int cached[2] = {-1, -1};
+
+    auto horizontal = [&](const unsigned char* in, uint16_t* out) {
+        auto from_table = [&](int i) {
+            const unsigned char* p0 = in + columns.index[i * 2] * C;
+            const unsigned char* p1 = in + columns.index[i * 2 + 1] * C;
+            unsigned a = static_cast<unsigned>(columns.weight[i * 2]);
+            unsigned b = static_cast<unsigned>(columns.weight[i * 2 + 1]);
+            for (int c = 0; c < C; ++c) {
+                out[i * C + c] = static_cast<uint16_t>(p0[c] * a + p1[c] * b);
+            }
+        };
+        for (int i = 0; i < N * m_begin; ++i) from_table(i);
+        for (int m = m_begin; m < m_end; ++m) {
+            const unsigned char* p = in + m * C;
+            uint16_t* q = out + static_cast<size_t>(m) * N * C;
+            for (int r = 0; r < N; ++r) {
+                for (int c = 0; c < C; ++c) {
+                    q[r * C + c] = static_cast<uint16_t>(p[offset[r] * C + c] * w0[r] +
+                                                         p[(offset[r] + 1) * C + c] * w1[r]);
+                }
+            }
+        }
+        for (int i = N * m_end; i < dst.width; ++i) from_table(i);
+    };
+
+    for (int y = 0; y < dst.height; ++y) {
+        const uint16_t* line[2];
+        unsigned weight[2];
+        for (int k = 0; k < 2; ++k) {
+            int index = rows.index[y * 2 + k];
+            int slot = index % 2;
+            if (cached[slot] != index) {
+                horizontal(src.row(index), ring[slot]);
+                cached[slot] = index;
+            }
+            line[k] = ring[slot];
+            weight[k] = static_cast<unsigned>(rows.weight[y * 2 + k]);
+        }
+
+        unsigned char* out = dst.row(y);
+        const uint16_t* a = line[0];
+        const uint16_t* b = line[1];
+        for (size_t j = 0; j < row_values; ++j) {
+            out[j] = static_cast<unsigned char>((a[j] * weight[0] + b[j] * weight[1]) >> 16);
+        }
+    }
+}
+
+// Reducción 1/N: cada salida es la media redondeada de un bloque N x N. Las
+// N filas del bloque se suman en 16 bits (bucle plano) y después se suman
+// los N píxeles contiguos de cada salida; la división es un desplazamiento.
+template <int C, int N>
+void Resampler::run_box(const ImageView& src, const ImageView& dst) const {
+    const int shift = N == 2 ? 2 : 4;
+    const size_t in_values = static_cast<size_t>(dst.width) * N * C;
+    std::vector<uint16_t> sums(in_values);
+
+    for (int y = 0; y < dst.height; ++y) {
+        const unsigned char* first = src.row(y * N);
+        for (size_t j = 0; j < in_values; ++j) {
+            sums[j] = first[j];
+        }
+        for (int r = 1; r < N; ++r) {
+            const unsigned char* in = src.row(y * N + r);
+            for (size_t j = 0; j < in_values; ++j) {
+                sums[j] = static_cast<uint16_t>(sums[j] + in[j]);
+            }
+        }
+
+        unsigned char* out = dst.row(y);
+        for (int x = 0; x < dst.width; ++x) {
+            const uint16_t* block = &sums[static_cast<size_t>(x) * N * C];
+            for (int c = 0; c < C; ++c) {
+                unsigned total = N * N / 2;
+                for (int k = 0; k < N; ++k) {
+                    total += block[k * C + c];
+                }
+                out[x * C + c] = static_cast<unsigned char>(total >> shift);
+            }
+        }
+    }
+}
+
+// Vecino más cercano: cada fila de salida copia píxeles enteros de su fila
+// de origen sin aritmética de coordenadas. Al ampliar, las filas que vienen
+// de la misma fila de origen se copian enteras de la anterior, y con una
+// razón entera cada píxel se replica N veces sin consultar la tabla.
+template <int C>
+void Resampler::run_nearest(const ImageView& src, const ImageView& dst) const {
+    const size_t row_bytes = static_cast<size_t>(dst.width) * C;
+    int replicated = 0;
+    if (ratio != 0) {
+        replicated = std::min(src.width, dst.width / ratio);
+    }
+
+    for (int y = 0; y < dst.height; ++y) {
+        unsigned char* out = dst.row(y);
+        if (y > 0 && rows.index[y] == rows.index[y - 1]) {
+            std::memcpy(out, dst.row(y - 1), row_bytes);
+            continue;
+        }
+
+        const unsigned char* in = src.row(rows.index[y]);
+        unsigned char* q = out;
+        for (int m = 0; m < replicated; ++m) {
+            for (int r = 0; r < ratio; ++r) {
+                std::memcpy(q, in + m * C, C);
+                q += C;
+            }
+        }
+        for (int x = replicated * ratio; x < dst.width; ++x) {
+            std::memcpy(out + x * C, in + columns.index[x] * C, C);
+        }
+    }
+}
+
+void Resampler::run(const ImageView& src, const ImageView& dst) const {
+    if (dst.width <= 0 || dst.height <= 0) {
+        return;
+    }
+    if (nearest) {
+        switch (src.channels) {
+            case 1: run_nearest<1>(src, dst); break;
+            case 2: run_nearest<2>(src, dst); break;
+            case 3: run_nearest<3>(src, dst); break;
+            default: run_nearest<4>(src, dst); break;
+        }
+        return;
+    }
+    if (ratio != 0) {
+        switch (ratio * 8 + src.channels) {
+            case 2 * 8 + 1: area ? run_box<1, 2>(src, dst) : run_upscale<1, 2>(src, dst); break;
+            case 2 * 8 + 2: area ? run_box<2, 2>(src, dst) : run_upscale<2, 2>(src, dst); break;
+            case 2 * 8 + 3: area ? run_box<3, 2>(src, dst) : run_upscale<3, 2>(src, dst); break;
+            case 2 * 8 + 4: area ? run_box<4, 2>(src, dst) : run_upscale<4, 2>(src, dst); break;
+            case 3 * 8 + 1: run_upscale<1, 3>(src, dst); break;
+            case 3 * 8 + 2: run_upscale<2, 3>(src, dst); break;
+            case 3 * 8 + 3: run_upscale<3, 3>(src, dst); break;
+            case 3 * 8 + 4: run_upscale<4, 3>(src, dst); break;
+            case 4 * 8 + 1: run_box<1, 4>(src, dst); break;
+            case 4 * 8 + 2: run_box<2, 4>(src, dst); break;
+            case 4 * 8 + 3: run_box<3, 4>(src, dst); break;
+            default: run_box<4, 4>(src, dst); break;
+        }
+        return;
+    }
+    if (area) {
+        switch (src.channels) {
+            case 1: run_area<1>(src, dst); break;
+            case 2: run_area<2>(src, dst); break;
+            case 3: run_area<3>(src, dst); break;
+            default: run_area<4>(src, dst); break;
+        }
+        return;
+    }
+    switch (columns.taps * 8 + src.channels) {
+        case 2 * 8 + 1: run_kernel<1, 2>(src, dst); break;
+        case 2 * 8 + 2: run_kernel<2, 2>(src, dst); break;
+        case 2 * 8 + 3: run_kernel<3, 2>(src, dst); break;
+        case 2 * 8 + 4: run_kernel<4, 2>(src, dst); break;
+        case 4 * 8 + 1: run_kernel<1, 4>(src, dst); break;
+        case 4 * 8 + 2: run_kernel<2, 4>(src, dst); break;
+        case 4 * 8 + 3: run_kernel<3, 4>(src, dst); break;
+        case 4 * 8 + 4: run_kernel<4, 4>(src, dst); break;
+        case 6 * 8 + 1: run_kernel<1, 6>(src, dst); break;
+        case 6 * 8 + 2: run_kernel<2, 6>(src, dst); break;
+        case 6 * 8 + 3: run_kernel<3, 6>(src, dst); break;
+        default: run_kernel<4, 6>(src, dst); break;
+    }
+}
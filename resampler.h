@@ -0,0 +1,96 @@
+#ifndef RESAMPLER_H
+#define RESAMPLER_H
+
+#include <vector>
+#include "image_buffer.h"
+
+// Escalado separable en dos pasadas. Cada eje tiene una tabla precalculada
+// con los índices de origen (ya acotados al borde) y los pesos de cada
+// posición de salida, de modo que no queda aritmética de coordenadas por
+// píxel. La pasada horizontal remuestrea cada fila de origen necesaria una
+// sola vez a una fila intermedia en float; la vertical recorre el destino de
+// arriba abajo combinando las filas intermedias, que se guardan en un anillo
+// de tantas filas como muestras verticales tiene el filtro.
+//
+// Con factor < 1 se usa en su lugar el promedio por áreas: cada píxel de
+// salida integra todos los píxeles de origen que cubre, ponderados por la
+// fracción solapada, acumulando sumas parciales por fila y por columna.
+//
+// El vecino más cercano no promedia en ningún caso: las tablas guardan un
+// solo índice por posición y la salida se copia píxel a píxel.
+
+// Filtros de interpolación para ampliar y rotar
+enum class Interpolation {
+    Nearest,   // Vecino más cercano (copia de píxeles, para vistas previas)
+    Bilinear,  // 2 muestras por eje
+    Bicubic,   // 4 muestras por eje (Keys, a = -0.5)
+    Lanczos3   // 6 muestras por eje
+};
+
+// Muestras por eje y peso del filtro a una distancia dada (sin normalizar)
+int interpolation_taps(Interpolation filter);
+double interpolation_weight(Interpolation filter, double distance);
+const char* interpolation_name(Interpolation filter);
+
+class Resampler {
+public:
+    // fixed: pesos enteros (8.8 en bilineal, con el mismo resultado que la
+    // interpolación en punto fijo; 12 bits en el resto); si no, pesos en
+    // float. El promedio por áreas acumula siempre en float.
+    //
+    // Las razones enteras tienen núcleos propios sin tablas por píxel:
+    // x2 y x3 bilineales con los pesos fijos de cada fase (8.8, igual que en
+    // punto fijo) y 1/2 y 1/4 como media exacta de bloques 2x2 y 4x4. Con
+    // vecino más cercano, cualquier ampliación entera replica cada píxel N
+    // veces.
+    Resampler(int src_width, int src_height, int dst_width, int dst_height,
+              double factor, bool fixed, Interpolation filter = Interpolation::Bilinear);
+
+    // src y dst con el mismo número de bytes por píxel (intercalado o plano)
+    void run(const ImageView& src, const ImageView& dst) const;
+
+private:
+    struct AxisTable {
+        int taps;                  // Muestras de origen por posición de salida
+        std::vector<int> index;    // taps índices de origen por posición
+        std::vector<float> weight; // taps pesos por posición
+    };
+
+    // Reparto de cada posición de origen entre las (como mucho) dos
+    // posiciones de salida que toca con factor < 1. Las posiciones que caen
+    // fuera del destino apuntan a dst_size y se descartan.
+    struct AreaTable {
+        std::vector<int> target;   // Primera posición de salida
+        std::vector<float> first;  // Peso hacia target
+        std::vector<float> second; // Peso hacia target + 1
+    };
+
+    static AxisTable bilinear_table(int src_size, int dst_size, double factor, bool fixed);
+    static AxisTable filter_table(int src_size, int dst_size, double factor, bool fixed,
+                                  Interpolation filter);
+    static AreaTable area_table(int src_size, int dst_size, double factor);
+    static AxisTable nearest_table(int src_size, int dst_size, double factor);
+
+    template <int C, int TAPS>
+    void run_kernel(const ImageView& src, const ImageView& dst) const;
+    template <int C>
+    void run_area(const ImageView& src, const ImageView& dst) const;
+    template <int C, int N>
+    void run_upscale(const ImageView& src, const ImageView& dst) const;
+    template <int C, int N>
+    void run_box(const ImageView& src, const ImageView& dst) const;
+    template <int C>
+    void run_nearest(const ImageView& src, const ImageView& dst) const;
+
+    bool area;
+    bool nearest;
+    int ratio;                 // N de una razón entera con núcleo propio (0 si no)
+    AxisTable columns;
+    AxisTable rows;
+    AreaTable area_columns;
+    AreaTable area_rows;
+    float scale;               // Normalización final (producto de las unidades en punto fijo)
+    float bias;                // 0.5 para redondear; 0 (truncar) en bilineal
+};
+
+#endif
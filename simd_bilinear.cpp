@@ -0,0 +1,397 @@
+#include "simd_bilinear.h"
+#include <climits>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define SIMD_BILINEAR_X86 1
+#include <immintrin.h>
+// Falso positivo de GCC 12 con los valores "indefinidos" de avx512fintrin.h
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+SimdLevel detect_simd_level() {
+#ifdef SIMD_BILINEAR_X86
+    // Puede llamarse desde un inicializador estático, antes que libgcc
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) return SimdLevel::AVX512;
+    if (__builtin_cpu_supports("avx2")) return SimdLevel::AVX2;
+    if (__builtin_cpu_supports("sse2")) return SimdLevel::SSE2;
+#endif
+    return SimdLevel::Scalar;
+}
+
+// Elegido una sola vez al arrancar el programa
+static SimdLevel active_level = detect_simd_level();
+
+SimdLevel get_simd_level() {
+    return active_level;
+}
+
+void set_simd_level(SimdLevel level) {
+    SimdLevel best = detect_simd_level();
+    active_level = static_cast<int>(level) < static_cast<int>(best) ? level : best;
+}
+
+const char* simd_level_name(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::SSE2: return "SSE2";
+        case SimdLevel::AVX2: return "AVX2";
+        case SimdLevel::AVX512: return "AVX-512";
+        default: return "escalar";
+    }
+}
+
+#ifdef SIMD_BILINEAR_X86
+
+// Los cuatro vecinos de cada muestra se leen con cargas de 32 bits. Con 1 y 2
+// canales una sola carga cubre la pareja horizontal (p00, p10); con 3 y 4 la
+// segunda carga empieza RIGHT bytes más allá. Ninguna carga pasa del último
+// byte de p10 / p11 salvo la superior de 1 canal, que adelanta 2 bytes sobre
+// la fila siguiente (siempre existe: y0 <= alto - 2); por eso la inferior de
+// 1 canal se lee BACK bytes antes. Sxx es el desplazamiento en bits del canal
+// 0 de cada vecino dentro de su carga.
+template <int C> struct Neighbours;
+template <> struct Neighbours<1> { enum { RIGHT = 0, BACK = 2, S10 = 8, S01 = 16, S11 = 24 }; };
+template <> struct Neighbours<2> { enum { RIGHT = 0, BACK = 0, S10 = 16, S01 = 0, S11 = 16 }; };
+template <> struct Neighbours<3> { enum { RIGHT = 2, BACK = 0, S10 = 8, S01 = 0, S11 = 8 }; };
+template <> struct Neighbours<4> { enum { RIGHT = 4, BACK = 0, S10 = 0, S01 = 0, S11 = 0 }; };
+
+// Escritura de píxeles empaquetados en 32 bits (canal 0 en el byte bajo)
+template <int C>
+static void store_pixels(unsigned char* out, const uint32_t* pixels, int n) {
+    for (int i = 0; i < n; ++i) {
+        std::memcpy(out + i * C, &pixels[i], C);
+    }
+}
+
+#define SIMD_TARGET_SSE2 __attribute__((target("sse2")))
+#define SIMD_TARGET_AVX2 __attribute__((target("avx2")))
+#define SIMD_TARGET_AVX512 __attribute__((target("avx512f")))
+
+// SSE2: 4 muestras por iteración. Sin instrucciones de recogida ni min/mul
+// de enteros de 32 bits: las coordenadas y pesos se calculan en vector y los
+// vecinos se cargan desde una tabla de desplazamientos precalculada.
+template <int C, bool PROJECTIVE, bool FIXED>
+SIMD_TARGET_SSE2 static int span_sse2(const BilinearSpan& s) {
+    typedef Neighbours<C> N;
+    const int L = 4;
+    int n = s.count - s.count % L;
+
+    const __m128 lane = _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f);
+    const __m128 step_x = _mm_mul_ps(lane, _mm_set1_ps(static_cast<float>(s.step_x)));
+    const __m128 step_y = _mm_mul_ps(lane, _mm_set1_ps(static_cast<float>(s.step_y)));
+    const __m128 step_w = _mm_mul_ps(lane, _mm_set1_ps(static_cast<float>(s.step_w)));
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 last_x = _mm_set1_ps(static_cast<float>(s.src.width - 2));
+    const __m128 last_y = _mm_set1_ps(static_cast<float>(s.src.height - 2));
+    const __m128 weight_one = _mm_set1_ps(FIXED ? 256.0f : 1.0f);
+    const __m128 weight_round = _mm_set1_ps(FIXED ? 0.5f : 0.0f);
+    const __m128 scale = _mm_set1_ps(FIXED ? 1.0f / 65536.0f : 1.0f);
+    const __m128i mask = _mm_set1_epi32(0xff);
+    const size_t bottom = s.src.stride - N::BACK;
+
+    alignas(16) int x0s[L], y0s[L];
+    alignas(16) uint32_t a[L], b[L], c[L], d[L], pixels[L];
+
+    for (int i = 0; i < n; i += L) {
+        __m128 sx = _mm_add_ps(_mm_set1_ps(static_cast<float>(s.x + i * s.step_x)), step_x);
+        __m128 sy = _mm_add_ps(_mm_set1_ps(static_cast<float>(s.y + i * s.step_y)), step_y);
+        if (PROJECTIVE) {
+            __m128 sw = _mm_add_ps(_mm_set1_ps(static_cast<float>(s.w + i * s.step_w)), step_w);
+            __m128 inverse = _mm_div_ps(one, sw);
+            sx = _mm_mul_ps(sx, inverse);
+            sy = _mm_mul_ps(sy, inverse);
+        }
+        sx = _mm_max_ps(sx, zero);
+        sy = _mm_max_ps(sy, zero);
+        __m128i x0 = _mm_cvttps_epi32(_mm_min_ps(sx, last_x));
+        __m128i y0 = _mm_cvttps_epi32(_mm_min_ps(sy, last_y));
+        __m128 wx = _mm_min_ps(_mm_sub_ps(sx, _mm_cvtepi32_ps(x0)), one);
+        __m128 wy = _mm_min_ps(_mm_sub_ps(sy, _mm_cvtepi32_ps(y0)), one);
+        wx = _mm_mul_ps(wx, weight_one);
+        wy = _mm_mul_ps(wy, weight_one);
+        if (FIXED) {
+            wx = _mm_cvtepi32_ps(_mm_cvttps_epi32(_mm_add_ps(wx, weight_round)));
+            wy = _mm_cvtepi32_ps(_mm_cvttps_epi32(_mm_add_ps(wy, weight_round)));
+        }
+        __m128 wx0 = _mm_sub_ps(weight_one, wx);
+        __m128 wy0 = _mm_sub_ps(weight_one, wy);
+
+        _mm_store_si128(reinterpret_cast<__m128i*>(x0s), x0);
+        _mm_store_si128(reinterpret_cast<__m128i*>(y0s), y0);
+        for (int l = 0; l < L; ++l) {
+            const unsigned char* p = s.src.row(y0s[l]) + x0s[l] * C;
+            std::memcpy(&a[l], p, 4);
+            std::memcpy(&c[l], p + bottom, 4);
+            if (N::RIGHT != 0) {
+                std::memcpy(&b[l], p + N::RIGHT, 4);
+                std::memcpy(&d[l], p + bottom + N::RIGHT, 4);
+            }
+        }
+        __m128i va = _mm_load_si128(reinterpret_cast<const __m128i*>(a));
+        __m128i vc = _mm_load_si128(reinterpret_cast<const __m128i*>(c));
+        __m128i vb = N::RIGHT != 0 ? _mm_load_si128(reinterpret_cast<const __m128i*>(b)) : va;
+        __m128i vd = N::RIGHT != 0 ? _mm_load_si128(reinterpret_cast<const __m128i*>(d)) : vc;
+
+        __m128i px = _mm_setzero_si128();
+        for (int k = 0; k < C; ++k) {
+            __m128 p00 = _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(va, 8 * k), mask));
+            __m128 p10 = _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(vb, 8 * k + N::S10), mask));
+            __m128 p01 = _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(vc, 8 * k + N::S01), mask));
+            __m128 p11 = _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(vd, 8 * k + N::S11), mask));
+            __m128 top = _mm_add_ps(_mm_mul_ps(p00, wx0), _mm_mul_ps(p10, wx));
+            __m128 low = _mm_add_ps(_mm_mul_ps(p01, wx0), _mm_mul_ps(p11, wx));
+            __m128 value = _mm_mul_ps(_mm_add_ps(_mm_mul_ps(top, wy0), _mm_mul_ps(low, wy)), scale);
+            px = _mm_or_si128(px, _mm_slli_epi32(_mm_cvttps_epi32(value), 8 * k));
+        }
+
+        unsigned char* out = s.out + static_cast<size_t>(i) * C;
+        if (C == 4) {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out), px);
+        } else if (C == 1) {
+            __m128i words = _mm_packs_epi32(px, px);
+            int packed = _mm_cvtsi128_si32(_mm_packus_epi16(words, words));
+            std::memcpy(out, &packed, L);
+        } else {
+            _mm_store_si128(reinterpret_cast<__m128i*>(pixels), px);
+            store_pixels<C>(out, pixels, L);
+        }
+    }
+    return n;
+}
+
+// AVX2: 8 muestras por iteración con recogidas (gather) de 32 bits
+template <int C, bool PROJECTIVE, bool FIXED>
+SIMD_TARGET_AVX2 static int span_avx2(const BilinearSpan& s) {
+    typedef Neighbours<C> N;
+    const int L = 8;
+    int n = s.count - s.count % L;
+    const int* base = reinterpret_cast<const int*>(s.src.data);
+
+    const __m256 lane = _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f);
+    const __m256 step_x = _mm256_mul_ps(lane, _mm256_set1_ps(static_cast<float>(s.step_x)));
+    const __m256 step_y = _mm256_mul_ps(lane, _mm256_set1_ps(static_cast<float>(s.step_y)));
+    const __m256 step_w = _mm256_mul_ps(lane, _mm256_set1_ps(static_cast<float>(s.step_w)));
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 last_x = _mm256_set1_ps(static_cast<float>(s.src.width - 2));
+    const __m256 last_y = _mm256_set1_ps(static_cast<float>(s.src.height - 2));
+    const __m256 weight_one = _mm256_set1_ps(FIXED ? 256.0f : 1.0f);
+    const __m256 weight_round = _mm256_set1_ps(FIXED ? 0.5f : 0.0f);
+    const __m256 scale = _mm256_set1_ps(FIXED ? 1.0f / 65536.0f : 1.0f);
+    const __m256i mask = _mm256_set1_epi32(0xff);
+    const __m256i stride = _mm256_set1_epi32(static_cast<int>(s.src.stride));
+    const __m256i pixel_bytes = _mm256_set1_epi32(C);
+    const __m256i bottom = _mm256_set1_epi32(static_cast<int>(s.src.stride) - N::BACK);
+    const __m256i right = _mm256_set1_epi32(N::RIGHT);
+
+    alignas(32) uint32_t pixels[L];
+
+    for (int i = 0; i < n; i += L) {
+        __m256 sx = _mm256_add_ps(_mm256_set1_ps(static_cast<float>(s.x + i * s.step_x)), step_x);
+        __m256 sy = _mm256_add_ps(_mm256_set1_ps(static_cast<float>(s.y + i * s.step_y)), step_y);
+        if (PROJECTIVE) {
+            __m256 sw = _mm256_add_ps(_mm256_set1_ps(static_cast<float>(s.w + i * s.step_w)), step_w);
+            __m256 inverse = _mm256_div_ps(one, sw);
+            sx = _mm256_mul_ps(sx, inverse);
+            sy = _mm256_mul_ps(sy, inverse);
+        }
+        sx = _mm256_max_ps(sx, zero);
+        sy = _mm256_max_ps(sy, zero);
+        __m256i x0 = _mm256_cvttps_epi32(_mm256_min_ps(sx, last_x));
+        __m256i y0 = _mm256_cvttps_epi32(_mm256_min_ps(sy, last_y));
+        __m256 wx = _mm256_min_ps(_mm256_sub_ps(sx, _mm256_cvtepi32_ps(x0)), one);
+        __m256 wy = _mm256_min_ps(_mm256_sub_ps(sy, _mm256_cvtepi32_ps(y0)), one);
+        wx = _mm256_mul_ps(wx, weight_one);
+        wy = _mm256_mul_ps(wy, weight_one);
+        if (FIXED) {
+            wx = _mm256_cvtepi32_ps(_mm256_cvttps_epi32(_mm256_add_ps(wx, weight_round)));
+            wy = _mm256_cvtepi32_ps(_mm256_cvttps_epi32(_mm256_add_ps(wy, weight_round)));
+        }
+        __m256 wx0 = _mm256_sub_ps(weight_one, wx);
+        __m256 wy0 = _mm256_sub_ps(weight_one, wy);
+
+        __m256i offset = _mm256_add_epi32(_mm256_mullo_epi32(y0, stride),
+                                          _mm256_mullo_epi32(x0, pixel_bytes));
+        __m256i offset_bottom = _mm256_add_epi32(offset, bottom);
+        __m256i va = _mm256_i32gather_epi32(base, offset, 1);
+        __m256i vc = _mm256_i32gather_epi32(base, offset_bottom, 1);
+        __m256i vb = va;
+        __m256i vd = vc;
+        if (N::RIGHT != 0) {
+            vb = _mm256_i32gather_epi32(base, _mm256_add_epi32(offset, right), 1);
+            vd = _mm256_i32gather_epi32(base, _mm256_add_epi32(offset_bottom, right), 1);
+        }
+
+        __m256i px = _mm256_setzero_si256();
+        for (int k = 0; k < C; ++k) {
+            __m256 p00 = _mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(va, 8 * k), mask));
+            __m256 p10 = _mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(vb, 8 * k + N::S10), mask));
+            __m256 p01 = _mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(vc, 8 * k + N::S01), mask));
+            __m256 p11 = _mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(vd, 8 * k + N::S11), mask));
+            __m256 top = _mm256_add_ps(_mm256_mul_ps(p00, wx0), _mm256_mul_ps(p10, wx));
+            __m256 low = _mm256_add_ps(_mm256_mul_ps(p01, wx0), _mm256_mul_ps(p11, wx));
+            __m256 value = _mm256_mul_ps(_mm256_add_ps(_mm256_mul_ps(top, wy0), _mm256_mul_ps(low, wy)), scale);
+            px = _mm256_or_si256(px, _mm256_slli_epi32(_mm256_cvttps_epi32(value), 8 * k));
+        }
+
+        unsigned char* out = s.out + static_cast<size_t>(i) * C;
+        if (C == 4) {
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), px);
+        } else if (C == 1 || C == 2) {
+            __m128i words = _mm_packus_epi32(_mm256_castsi256_si128(px), _mm256_extracti128_si256(px, 1));
+            if (C == 1) {
+                _mm_storel_epi64(reinterpret_cast<__m128i*>(out), _mm_packus_epi16(words, words));
+            } else {
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out), words);
+            }
+        } else {
+            _mm256_store_si256(reinterpret_cast<__m256i*>(pixels), px);
+            store_pixels<C>(out, pixels, L);
+        }
+    }
+    return n;
+}
+
+// AVX-512: 16 muestras por iteración; las conversiones con estrechamiento
+// escriben directamente 1 y 2 bytes por píxel
+template <int C, bool PROJECTIVE, bool FIXED>
+SIMD_TARGET_AVX512 static int span_avx512(const BilinearSpan& s) {
+    typedef Neighbours<C> N;
+    const int L = 16;
+    int n = s.count - s.count % L;
+    const int* base = reinterpret_cast<const int*>(s.src.data);
+
+    const __m512 lane = _mm512_cvtepi32_ps(
+        _mm512_set_epi32(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0));
+    const __m512 step_x = _mm512_mul_ps(lane, _mm512_set1_ps(static_cast<float>(s.step_x)));
+    const __m512 step_y = _mm512_mul_ps(lane, _mm512_set1_ps(static_cast<float>(s.step_y)));
+    const __m512 step_w = _mm512_mul_ps(lane, _mm512_set1_ps(static_cast<float>(s.step_w)));
+    const __m512 zero = _mm512_setzero_ps();
+    const __m512 one = _mm512_set1_ps(1.0f);
+    const __m512 last_x = _mm512_set1_ps(static_cast<float>(s.src.width - 2));
+    const __m512 last_y = _mm512_set1_ps(static_cast<float>(s.src.height - 2));
+    const __m512 weight_one = _mm512_set1_ps(FIXED ? 256.0f : 1.0f);
+    const __m512 weight_round = _mm512_set1_ps(FIXED ? 0.5f : 0.0f);
+    const __m512 scale = _mm512_set1_ps(FIXED ? 1.0f / 65536.0f : 1.0f);
+    const __m512i mask = _mm512_set1_epi32(0xff);
+    const __m512i stride = _mm512_set1_epi32(static_cast<int>(s.src.stride));
+    const __m512i pixel_bytes = _mm512_set1_epi32(C);
+    const __m512i bottom = _mm512_set1_epi32(static_cast<int>(s.src.stride) - N::BACK);
+    const __m512i right = _mm512_set1_epi32(N::RIGHT);
+
+    alignas(64) uint32_t pixels[L];
+
+    for (int i = 0; i < n; i += L) {
+        __m512 sx = _mm512_add_ps(_mm512_set1_ps(static_cast<float>(s.x + i * s.step_x)), step_x);
+        __m512 sy = _mm512_add_ps(_mm512_set1_ps(static_cast<float>(s.y + i * s.step_y)), step_y);
+        if (PROJECTIVE) {
+            __m512 sw = _mm512_add_ps(_mm512_set1_ps(static_cast<float>(s.w + i * s.step_w)), step_w);
+            __m512 inverse = _mm512_div_ps(one, sw);
+            sx = _mm512_mul_ps(sx, inverse);
+            sy = _mm512_mul_ps(sy, inverse);
+        }
+        sx = _mm512_max_ps(sx, zero);
+        sy = _mm512_max_ps(sy, zero);
+        __m512i x0 = _mm512_cvttps_epi32(_mm512_min_ps(sx, last_x));
+        __m512i y0 = _mm512_cvttps_epi32(_mm512_min_ps(sy, last_y));
+        __m512 wx = _mm512_min_ps(_mm512_sub_ps(sx, _mm512_cvtepi32_ps(x0)), one);
+        __m512 wy = _mm512_min_ps(_mm512_sub_ps(sy, _mm512_cvtepi32_ps(y0)), one);
+        wx = _mm512_mul_ps(wx, weight_one);
+        wy = _mm512_mul_ps(wy, weight_one);
+        if (FIXED) {
+            wx = _mm512_cvtepi32_ps(_mm512_cvttps_epi32(_mm512_add_ps(wx, weight_round)));
+            wy = _mm512_cvtepi32_ps(_mm512_cvttps_epi32(_mm512_add_ps(wy, weight_round)));
+        }
+        __m512 wx0 = _mm512_sub_ps(weight_one, wx);
+        __m512 wy0 = _mm512_sub_ps(weight_one, wy);
+
+        __m512i offset = _mm512_add_epi32(_mm512_mullo_epi32(y0, stride),
+                                          _mm512_mullo_epi32(x0, pixel_bytes));
+        __m512i offset_bottom = _mm512_add_epi32(offset, bottom);
+        __m512i va = _mm512_i32gather_epi32(offset, base, 1);
+        __m512i vc = _mm512_i32gather_epi32(offset_bottom, base, 1);
+        __m512i vb = va;
+        __m512i vd = vc;
+        if (N::RIGHT != 0) {
+            vb = _mm512_i32gather_epi32(_mm512_add_epi32(offset, right), base, 1);
+            vd = _mm512_i32gather_epi32(_mm512_add_epi32(offset_bottom, right), base, 1);
+        }
+
+        __m512i px = _mm512_setzero_si512();
+        for (int k = 0; k < C; ++k) {
+            __m512 p00 = _mm512_cvtepi32_ps(_mm512_and_si512(_mm512_srli_epi32(va, 8 * k), mask));
+            __m512 p10 = _mm512_cvtepi32_ps(_mm512_and_si512(_mm512_srli_epi32(vb, 8 * k + N::S10), mask));
+            __m512 p01 = _mm512_cvtepi32_ps(_mm512_and_si512(_mm512_srli_epi32(vc, 8 * k + N::S01), mask));
+            __m512 p11 = _mm512_cvtepi32_ps(_mm512_and_si512(_mm512_srli_epi32(vd, 8 * k + N::S11), mask));
+            __m512 top = _mm512_add_ps(_mm512_mul_ps(p00, wx0), _mm512_mul_ps(p10, wx));
+            __m512 low = _mm512_add_ps(_mm512_mul_ps(p01, wx0), _mm512_mul_ps(p11, wx));
+            __m512 value = _mm512_mul_ps(_mm512_add_ps(_mm512_mul_ps(top, wy0), _mm512_mul_ps(low, wy)), scale);
+            px = _mm512_or_si512(px, _mm512_slli_epi32(_mm512_cvttps_epi32(value), 8 * k));
+        }
+
+        unsigned char* out = s.out + static_cast<size_t>(i) * C;
+        if (C == 4) {
+            _mm512_storeu_si512(out, px);
+        } else if (C == 2) {
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), _mm512_cvtepi32_epi16(px));
+        } else if (C == 1) {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm512_cvtepi32_epi8(px));
+        } else {
+            _mm512_store_si512(pixels, px);
+            store_pixels<C>(out, pixels, L);
+        }
+    }
+    return n;
+}
+
+typedef int (*SpanKernel)(const BilinearSpan&);
+
+// Tablas [punto fijo][proyectivo][canales - 1]: cada combinación es una
+// instancia propia, sin comprobaciones de modo dentro del bucle
+static SpanKernel select_kernel(SimdLevel level, int channels, bool projective, bool fixed) {
+    static const SpanKernel sse2[2][2][4] = {
+        {{span_sse2<1, false, false>, span_sse2<2, false, false>, span_sse2<3, false, false>, span_sse2<4, false, false>},
+         {span_sse2<1, true, false>, span_sse2<2, true, false>, span_sse2<3, true, false>, span_sse2<4, true, false>}},
+        {{span_sse2<1, false, true>, span_sse2<2, false, true>, span_sse2<3, false, true>, span_sse2<4, false, true>},
+         {span_sse2<1, true, true>, span_sse2<2, true, true>, span_sse2<3, true, true>, span_sse2<4, true, true>}}};
+    static const SpanKernel avx2[2][2][4] = {
+        {{span_avx2<1, false, false>, span_avx2<2, false, false>, span_avx2<3, false, false>, span_avx2<4, false, false>},
+         {span_avx2<1, true, false>, span_avx2<2, true, false>, span_avx2<3, true, false>, span_avx2<4, true, false>}},
+        {{span_avx2<1, false, true>, span_avx2<2, false, true>, span_avx2<3, false, true>, span_avx2<4, false, true>},
+         {span_avx2<1, true, true>, span_avx2<2, true, true>, span_avx2<3, true, true>, span_avx2<4, true, true>}}};
+    static const SpanKernel avx512[2][2][4] = {
+        {{span_avx512<1, false, false>, span_avx512<2, false, false>, span_avx512<3, false, false>, span_avx512<4, false, false>},
+         {span_avx512<1, true, false>, span_avx512<2, true, false>, span_avx512<3, true, false>, span_avx512<4, true, false>}},
+        {{span_avx512<1, false, true>, span_avx512<2, false, true>, span_avx512<3, false, true>, span_avx512<4, false, true>},
+         {span_avx512<1, true, true>, span_avx512<2, true, true>, span_avx512<3, true, true>, span_avx512<4, true, true>}}};
+    switch (level) {
+        case SimdLevel::SSE2: return sse2[fixed][projective][channels - 1];
+        case SimdLevel::AVX2: return avx2[fixed][projective][channels - 1];
+        case SimdLevel::AVX512: return avx512[fixed][projective][channels - 1];
+        default: return nullptr;
+    }
+}
+
+#endif
+
+int bilinear_span(const BilinearSpan& span, bool fixed) {
+#ifdef SIMD_BILINEAR_X86
+    const ImageView& src = span.src;
+    if (active_level == SimdLevel::Scalar || span.count <= 0) return 0;
+    if (src.channels < 1 || src.channels > 4 || src.width < 2 || src.height < 2) return 0;
+
+    // Las recogidas usan desplazamientos de 32 bits con signo
+    if (static_cast<size_t>(src.height) * src.stride > static_cast<size_t>(INT_MAX)) return 0;
+
+    bool projective = span.w != 1 || span.step_w != 0;
+    return select_kernel(active_level, src.channels, projective, fixed)(span);
+#else
+    (void)span;
+    (void)fixed;
+    return 0;
+#endif
+}
@@ -0,0 +1,43 @@
+#ifndef SIMD_BILINEAR_H
+#define SIMD_BILINEAR_H
+
+#include "image_buffer.h"
+
+// Tramo de muestras bilineales de una fila de salida: el píxel i del tramo
+// (0 <= i < count) toma su valor del punto (x + i * step_x, y + i * step_y)
+// del origen, con los mismos criterios de borde que la interpolación escalar
+// (coordenadas negativas a 0 y vecinos acotados al último píxel).
+//
+// En una homografía ambas coordenadas se dividen además por el denominador
+// w + i * step_w, con un solo recíproco por píxel; con los valores por
+// defecto (1 y 0) el tramo es afín y no se divide.
+struct BilinearSpan {
+    ImageView src;         // Origen intercalado (1-4 bytes/píxel) o un plano
+    double x;
+    double y;
+    double step_x;
+    double step_y;
+    int count;
+    unsigned char* out;    // count * src.channels bytes
+    double w = 1;
+    double step_w = 0;
+};
+
+// Juegos de instrucciones para los núcleos vectorizados, de menor a mayor
+enum class SimdLevel { Scalar, SSE2, AVX2, AVX512 };
+
+// Mejor nivel soportado por la CPU (se consulta una vez al arrancar)
+SimdLevel detect_simd_level();
+
+// Nivel en uso; set_simd_level() nunca sube por encima del detectado
+SimdLevel get_simd_level();
+void set_simd_level(SimdLevel level);
+const char* simd_level_name(SimdLevel level);
+
+// Muestrea el mayor prefijo del tramo que cubren bloques completos del
+// vector activo y devuelve cuántos píxeles escribió (0 con nivel escalar o
+// si el origen no admite índices de 32 bits). El resto queda para el
+// muestreo escalar. fixed selecciona los pesos 8.8 de la variante entera.
+int bilinear_span(const BilinearSpan& span, bool fixed);
+
+#endif
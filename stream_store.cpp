@@ -0,0 +1,74 @@
+#include "stream_store.h"
+#include <cstdint>
+#include <cstring>
+#include <unistd.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+size_t last_level_cache_size() {
+    long bytes = -1;
+#ifdef _SC_LEVEL3_CACHE_SIZE
+    bytes = sysconf(_SC_LEVEL3_CACHE_SIZE);
+    if (bytes <= 0) bytes = sysconf(_SC_LEVEL2_CACHE_SIZE);
+#endif
+    return bytes > 0 ? static_cast<size_t>(bytes) : 8u * 1024u * 1024u;
+}
+
+// Elegido una sola vez al arrancar el programa
+static size_t streaming_threshold = last_level_cache_size();
+
+size_t get_streaming_threshold() {
+    return streaming_threshold;
+}
+
+void set_streaming_threshold(size_t bytes) {
+    streaming_threshold = bytes;
+}
+
+bool streaming_output(size_t bytes) {
+    return bytes >= streaming_threshold;
+}
+
+void stream_copy(unsigned char* dst, const unsigned char* src, size_t bytes) {
+#ifdef __SSE2__
+    // Una línea escrita a medias obliga a leerla de memoria al vaciar el
+    // buffer de combinación: solo las líneas completas van sin caché
+    size_t head = (64 - (reinterpret_cast<uintptr_t>(dst) & 63)) & 63;
+    if (head >= bytes) {
+        std::memcpy(dst, src, bytes);
+        return;
+    }
+    std::memcpy(dst, src, head);
+    dst += head;
+    src += head;
+    bytes -= head;
+    for (; bytes >= 64; bytes -= 64, dst += 64, src += 64) {
+        __m128i* out = reinterpret_cast<__m128i*>(dst);
+        const __m128i* in = reinterpret_cast<const __m128i*>(src);
+        _mm_stream_si128(out, _mm_loadu_si128(in));
+        _mm_stream_si128(out + 1, _mm_loadu_si128(in + 1));
+        _mm_stream_si128(out + 2, _mm_loadu_si128(in + 2));
+        _mm_stream_si128(out + 3, _mm_loadu_si128(in + 3));
+    }
+#endif
+    std::memcpy(dst, src, bytes);
+}
+
+void stream_fence() {
+#ifdef __SSE2__
+    _mm_sfence();
+#endif
+}
+
+OutputRows::OutputRows(const ImageView& dst, bool stream)
+    : dst(dst), stream(stream),
+      row_bytes(static_cast<size_t>(dst.width) * dst.channels),
+      staging(stream ? row_bytes : 0) {}
+
+OutputRows::~OutputRows() {
+    if (stream) {
+        stream_fence();
+    }
+}
@@ -0,0 +1,69 @@
+#ifndef STREAM_STORE_H
+#define STREAM_STORE_H
+
+#include <cstddef>
+#include <vector>
+#include "image_buffer.h"
+
+// Escritura no temporal de salidas grandes. Cuando el destino es mucho mayor
+// que la caché de último nivel, escribirlo por la caché expulsa las líneas
+// del origen que el núcleo aún va a leer y cada línea de salida se lee de
+// memoria antes de sobrescribirla. Las escrituras no temporales van
+// directamente a memoria a través de los buffers de combinación de
+// escritura; no quedan ordenadas con el resto hasta un sfence.
+//
+// Lo usan los núcleos bilineales de rotate y affine, que componen la salida
+// en trozos de tesela que caben en L1. En los núcleos que componen filas
+// enteras (perspectiva, escalado) la copia desde la fila intermedia costó
+// más de lo que ahorraba y siguen escribiendo por la caché.
+
+// Tamaño de la caché de último nivel (o una estimación si el sistema no lo
+// informa)
+size_t last_level_cache_size();
+
+// Las salidas de al menos este número de bytes se escriben sin pasar por la
+// caché. Por defecto, el tamaño de la caché de último nivel; 0 siempre y
+// SIZE_MAX nunca.
+size_t get_streaming_threshold();
+void set_streaming_threshold(size_t bytes);
+bool streaming_output(size_t bytes);
+
+// Copia con escrituras no temporales de las líneas de 64 bytes completas
+// del destino; los extremos sin línea completa se copian normalmente
+void stream_copy(unsigned char* dst, const unsigned char* src, size_t bytes);
+
+// Ordena las escrituras no temporales anteriores antes que las siguientes
+void stream_fence();
+
+// Destino de un núcleo que escribe fila a fila (o por tramos de fila). Con
+// escritura no temporal, row() devuelve un buffer intermedio del ancho de
+// la fila, que se queda en caché, y commit() vuelca al destino los bytes
+// escritos; al destruirse emite el sfence. Sin ella row() es la propia fila
+// del destino y commit() no hace nada.
+class OutputRows {
+public:
+    OutputRows(const ImageView& dst, bool stream);
+    ~OutputRows();
+
+    bool streaming() const { return stream; }
+
+    unsigned char* row(int y) { return stream ? staging.data() : dst.row(y); }
+
+    void commit(int y) { commit(y, 0, row_bytes); }
+    void commit(int y, size_t begin, size_t end) {
+        if (stream && end > begin) {
+            stream_copy(dst.row(y) + begin, staging.data() + begin, end - begin);
+        }
+    }
+
+private:
+    ImageView dst;
+    bool stream;
+    size_t row_bytes;
+    std::vector<unsigned char> staging;
+
+    OutputRows(const OutputRows&) = delete;
+    OutputRows& operator=(const OutputRows&) = delete;
+};
+
+#endif
@@ -0,0 +1,62 @@
+#include "tiled_image.h"
+#include "pixel_buffer_pool.h"
+#include <algorithm>
+#include <cstring>
+
+const int TiledImage::TILE_SHIFT;
+const int TiledImage::TILE;
+const int TiledImage::TILE_SPAN;
+
+TiledImage::TiledImage()
+    : tiles(nullptr), width(0), height(0), channels(0), tiles_x(0), tiles_y(0), tile_bytes(0) {}
+
+TiledImage::~TiledImage() {
+    clear();
+}
+
+void TiledImage::clear() {
+    if (tiles) {
+        PixelBufferPool::shared().release(tiles);
+        tiles = nullptr;
+    }
+}
+
+void TiledImage::from_view(const ImageView& src) {
+    clear();
+
+    width = src.width;
+    height = src.height;
+    channels = src.channels;
+    tiles_x = (width + TILE - 1) >> TILE_SHIFT;
+    tiles_y = (height + TILE - 1) >> TILE_SHIFT;
+    tile_bytes = ImageBuffer::aligned_stride(TILE_SPAN * row_bytes());
+
+    // La memoria de las teselas también se recicla a través del pool
+    size_t total = tile_bytes * tiles_x * tiles_y;
+    tiles = static_cast<unsigned char*>(
+        PixelBufferPool::shared().acquire(width, height, 0x200u | channels, total));
+
+    for (int ty = 0; ty < tiles_y; ++ty) {
+        for (int tx = 0; tx < tiles_x; ++tx) {
+            unsigned char* tile = tiles + (static_cast<size_t>(ty) * tiles_x + tx) * tile_bytes;
+            int x_begin = tx * TILE;
+            int y_begin = ty * TILE;
+
+            // Columnas disponibles en el origen; las que sobran (borde derecho)
+            // repiten el último píxel
+            int copy_w = std::min(TILE_SPAN, width - x_begin);
+
+            for (int ly = 0; ly < TILE_SPAN; ++ly) {
+                int sy = std::min(y_begin + ly, height - 1);
+                const unsigned char* src_row = src.row(sy) + static_cast<size_t>(x_begin) * channels;
+                unsigned char* dst_row = tile + ly * row_bytes();
+
+                std::memcpy(dst_row, src_row, static_cast<size_t>(copy_w) * channels);
+                const unsigned char* last = src_row + static_cast<size_t>(copy_w - 1) * channels;
+                for (int lx = copy_w; lx < TILE_SPAN; ++lx) {
+                    std::memcpy(dst_row + lx * channels, last, channels);
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,142 @@
+#include "transform.h"
+#include <algorithm>
+#include <cmath>
+
+AffineTransform AffineTransform::identity() {
+    return AffineTransform{1, 0, 0, 0, 1, 0};
+}
+
+AffineTransform AffineTransform::translation(double tx, double ty) {
+    return AffineTransform{1, 0, tx, 0, 1, ty};
+}
+
+AffineTransform AffineTransform::scaling(double sx, double sy) {
+    return AffineTransform{sx, 0, 0, 0, sy, 0};
+}
+
+// rotate() toma el origen de cada píxel con [[cos, sin], [-sin, cos]]; el
+// sentido directo es la inversa (la traspuesta)
+AffineTransform AffineTransform::rotation(double degrees, double center_x, double center_y) {
+    double radians = degrees * M_PI / 180.0;
+    double cos_a = std::cos(radians);
+    double sin_a = std::sin(radians);
+    AffineTransform turn{cos_a, -sin_a, 0, sin_a, cos_a, 0};
+    return translation(center_x, center_y) * turn * translation(-center_x, -center_y);
+}
+
+AffineTransform AffineTransform::pixel_scaling(double sx, double sy) {
+    return translation(-0.5, -0.5) * scaling(sx, sy) * translation(0.5, 0.5);
+}
+
+AffineTransform AffineTransform::operator*(const AffineTransform& o) const {
+    return AffineTransform{
+        a * o.a + b * o.c, a * o.b + b * o.d, a * o.tx + b * o.ty + tx,
+        c * o.a + d * o.c, c * o.b + d * o.d, c * o.tx + d * o.ty + ty
+    };
+}
+
+bool AffineTransform::invert(AffineTransform& inverse) const {
+    double det = a * d - b * c;
+    if (std::fabs(det) < 1e-12) {
+        return false;
+    }
+    inverse.a = d / det;
+    inverse.b = -b / det;
+    inverse.c = -c / det;
+    inverse.d = a / det;
+    inverse.tx = -(inverse.a * tx + inverse.b * ty);
+    inverse.ty = -(inverse.c * tx + inverse.d * ty);
+    return true;
+}
+
+Homography Homography::identity() {
+    return Homography{{1, 0, 0, 0, 1, 0, 0, 0, 1}};
+}
+
+Homography Homography::from_affine(const AffineTransform& affine) {
+    return Homography{{affine.a, affine.b, affine.tx, affine.c, affine.d, affine.ty, 0, 0, 1}};
+}
+
+// Con h[8] = 1 cada pareja de puntos da dos ecuaciones lineales en las otras
+// ocho incógnitas:
+//   h0 x + h1 y + h2 - h6 x X - h7 y X = X
+//   h3 x + h4 y + h5 - h6 x Y - h7 y Y = Y
+// El sistema 8x8 se resuelve por eliminación gaussiana con pivote parcial.
+bool Homography::from_quad(const double* from, const double* to, Homography& result) {
+    double m[8][9];
+    for (int i = 0; i < 4; ++i) {
+        double x = from[2 * i], y = from[2 * i + 1];
+        double X = to[2 * i], Y = to[2 * i + 1];
+        double row_x[9] = {x, y, 1, 0, 0, 0, -x * X, -y * X, X};
+        double row_y[9] = {0, 0, 0, x, y, 1, -x * Y, -y * Y, Y};
+        std::copy(row_x, row_x + 9, m[2 * i]);
+        std::copy(row_y, row_y + 9, m[2 * i + 1]);
+    }
+
+    for (int col = 0; col < 8; ++col) {
+        int pivot = col;
+        for (int r = col + 1; r < 8; ++r) {
+            if (std::fabs(m[r][col]) > std::fabs(m[pivot][col])) pivot = r;
+        }
+        if (std::fabs(m[pivot][col]) < 1e-12) {
+            return false;
+        }
+        std::swap(m[col], m[pivot]);
+        for (int r = 0; r < 8; ++r) {
+            if (r == col) continue;
+            double f = m[r][col] / m[col][col];
+            for (int k = col; k < 9; ++k) {
+                m[r][k] -= f * m[col][k];
+            }
+        }
+    }
+
+    for (int i = 0; i < 8; ++i) {
+        result.h[i] = m[i][8] / m[i][i];
+    }
+    result.h[8] = 1;
+    return true;
+}
+
+Homography Homography::operator*(const Homography& o) const {
+    Homography r;
+    for (int i = 0; i < 3; ++i) {
+        for (int j = 0; j < 3; ++j) {
+            r.h[3 * i + j] = h[3 * i] * o.h[j] + h[3 * i + 1] * o.h[3 + j] + h[3 * i + 2] * o.h[6 + j];
+        }
+    }
+    return r;
+}
+
+// Inversa por la adjunta; el factor de escala común no altera la homografía,
+// pero se divide por el determinante para que la inversa de una afín siga
+// teniendo h[8] = 1
+bool Homography::invert(Homography& inverse) const {
+    const double* m = h;
+    double c0 = m[4] * m[8] - m[5] * m[7];
+    double c1 = m[5] * m[6] - m[3] * m[8];
+    double c2 = m[3] * m[7] - m[4] * m[6];
+    double det = m[0] * c0 + m[1] * c1 + m[2] * c2;
+    if (std::fabs(det) < 1e-12) {
+        return false;
+    }
+    double adjugate[9] = {
+        c0, m[2] * m[7] - m[1] * m[8], m[1] * m[5] - m[2] * m[4],
+        c1, m[0] * m[8] - m[2] * m[6], m[2] * m[3] - m[0] * m[5],
+        c2, m[1] * m[6] - m[0] * m[7], m[0] * m[4] - m[1] * m[3]
+    };
+    for (int i = 0; i < 9; ++i) {
+        inverse.h[i] = adjugate[i] / det;
+    }
+    return true;
+}
+
+bool Homography::apply(double x, double y, double& out_x, double& out_y) const {
+    double w = h[6] * x + h[7] * y + h[8];
+    if (w == 0) {
+        return false;
+    }
+    out_x = (h[0] * x + h[1] * y + h[2]) / w;
+    out_y = (h[3] * x + h[4] * y + h[5]) / w;
+    return true;
+}
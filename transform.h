@@ -0,0 +1,64 @@
+#ifndef TRANSFORM_H
+#define TRANSFORM_H
+
+// Transformación afín del plano en coordenadas de píxel (x a la derecha, y
+// hacia abajo):
+//   x' = a * x + b * y + tx
+//   y' = c * x + d * y + ty
+// Se describe en sentido directo (del origen al destino); los núcleos de
+// remuestreo usan la inversa para recorrer el destino.
+struct AffineTransform {
+    double a, b, tx;
+    double c, d, ty;
+
+    static AffineTransform identity();
+    static AffineTransform translation(double tx, double ty);
+    static AffineTransform scaling(double sx, double sy);
+
+    // Giro de 'degrees' grados alrededor de (center_x, center_y), en el
+    // mismo sentido que ImageProcessor::rotate
+    static AffineTransform rotation(double degrees, double center_x = 0, double center_y = 0);
+
+    // Escalado de imagen: los centros de los píxeles (i + 0.5) se escalan
+    // desde el origen, igual que en ImageProcessor::scale
+    static AffineTransform pixel_scaling(double sx, double sy);
+
+    // Composición: (*this * other)(p) = (*this)(other(p))
+    AffineTransform operator*(const AffineTransform& other) const;
+
+    // false si la matriz es singular
+    bool invert(AffineTransform& inverse) const;
+
+    void apply(double x, double y, double& out_x, double& out_y) const {
+        out_x = a * x + b * y + tx;
+        out_y = c * x + d * y + ty;
+    }
+};
+
+// Homografía (transformación proyectiva) en las mismas coordenadas:
+//   x' = (h[0] * x + h[1] * y + h[2]) / (h[6] * x + h[7] * y + h[8])
+//   y' = (h[3] * x + h[4] * y + h[5]) / (h[6] * x + h[7] * y + h[8])
+// Corrige la perspectiva de fotos de documentos (trapecios en vez de
+// rectángulos). La afín es el caso h[6] = h[7] = 0, h[8] = 1.
+struct Homography {
+    double h[9];
+
+    static Homography identity();
+    static Homography from_affine(const AffineTransform& affine);
+
+    // Homografía que lleva los cuatro puntos from a los cuatro puntos to
+    // (x e y intercalados); false si el sistema es singular (tres puntos
+    // alineados)
+    static bool from_quad(const double* from, const double* to, Homography& result);
+
+    // Composición: (*this * other)(p) = (*this)(other(p))
+    Homography operator*(const Homography& other) const;
+
+    // false si la matriz es singular
+    bool invert(Homography& inverse) const;
+
+    // false si el punto va al infinito (denominador nulo)
+    bool apply(double x, double y, double& out_x, double& out_y) const;
+};
+
+#endif